@@ -0,0 +1,234 @@
+#include "BarnesHut.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+
+void Bodies::Resize(int n) {
+    x.resize(n); y.resize(n);
+    vx.resize(n); vy.resize(n);
+    ax.resize(n); ay.resize(n);
+    mass.resize(n);
+}
+
+// Spread the low 16 bits of v so there is a zero between each bit
+static uint32_t SpreadBits(uint32_t v) {
+    v &= 0x0000ffff;
+    v = (v | (v << 8)) & 0x00ff00ff;
+    v = (v | (v << 4)) & 0x0f0f0f0f;
+    v = (v | (v << 2)) & 0x33333333;
+    v = (v | (v << 1)) & 0x55555555;
+    return v;
+}
+
+// Quadrant (0..3) of a Morton code at a given tree level
+static inline int Quadrant(uint32_t code, int level) {
+    return (code >> (30 - 2 * level)) & 3;
+}
+
+static const int MAX_LEVEL = 16;   // 16 bits per axis
+
+float BarnesHut::SortByMorton(Bodies& b) {
+    int n = b.Size();
+
+    float minX = b.x[0], maxX = b.x[0];
+    float minY = b.y[0], maxY = b.y[0];
+    for (int i = 1; i < n; i++) {
+        minX = std::min(minX, b.x[i]); maxX = std::max(maxX, b.x[i]);
+        minY = std::min(minY, b.y[i]); maxY = std::max(maxY, b.y[i]);
+    }
+    float size = std::max(maxX - minX, maxY - minY);
+    if (size <= 0.0f) size = 1.0f;
+    float scale = 65535.0f / size;
+
+    codes.resize(n); order.resize(n);
+    codesTmp.resize(n); orderTmp.resize(n);
+    for (int i = 0; i < n; i++) {
+        uint32_t qx = (uint32_t)((b.x[i] - minX) * scale);
+        uint32_t qy = (uint32_t)((b.y[i] - minY) * scale);
+        codes[i] = SpreadBits(qx) | (SpreadBits(qy) << 1);
+        order[i] = i;
+    }
+
+    // LSD radix sort, 4 passes of 8 bits
+    for (int shift = 0; shift < 32; shift += 8) {
+        int count[257] = {0};
+        for (int i = 0; i < n; i++) count[((codes[i] >> shift) & 0xff) + 1]++;
+        for (int k = 0; k < 256; k++) count[k + 1] += count[k];
+        for (int i = 0; i < n; i++) {
+            int dst = count[(codes[i] >> shift) & 0xff]++;
+            codesTmp[dst] = codes[i];
+            orderTmp[dst] = order[i];
+        }
+        codes.swap(codesTmp);
+        order.swap(orderTmp);
+    }
+
+    // Apply the permutation to every per-body array
+    scratch.resize(n);
+    for (std::vector<float>* a : { &b.x, &b.y, &b.vx, &b.vy, &b.mass }) {
+        for (int i = 0; i < n; i++) scratch[i] = (*a)[order[i]];
+        a->swap(scratch);
+    }
+
+    return size;
+}
+
+void BarnesHut::BuildNode(int index, int begin, int end, int level, float size) {
+    QuadNode node;
+    node.size = size;
+    node.begin = begin;
+    node.end = end;
+    node.firstChild = -1;
+    node.childCount = 0;
+
+    if (end - begin <= leafSize || level == MAX_LEVEL) {
+        nodes[index] = node;
+        return;
+    }
+
+    // Bodies are sorted, so each quadrant is a contiguous sub-range
+    int split[5];
+    split[0] = begin;
+    split[4] = end;
+    for (int q = 1; q < 4; q++) {
+        split[q] = (int)(std::lower_bound(codes.begin() + split[q - 1], codes.begin() + end, q,
+            [level](uint32_t code, int quad) { return Quadrant(code, level) < quad; }) - codes.begin());
+    }
+
+    int first = (int)nodes.size();
+    int count = 0;
+    for (int q = 0; q < 4; q++) if (split[q + 1] > split[q]) count++;
+    nodes.resize(first + count);
+    node.firstChild = first;
+    node.childCount = count;
+    nodes[index] = node;
+
+    int child = first;
+    for (int q = 0; q < 4; q++) {
+        if (split[q + 1] > split[q])
+            BuildNode(child++, split[q], split[q + 1], level + 1, size * 0.5f);
+    }
+}
+
+void BarnesHut::Build(Bodies& b) {
+    nodes.clear();
+    if (b.Size() == 0) return;
+
+    // Root square covers the bounding box
+    float rootSize = SortByMorton(b);
+    nodes.resize(1);
+    BuildNode(0, 0, b.Size(), 0, rootSize);
+
+    // Mass and centre of mass bottom-up; children always follow their parent
+    for (int i = (int)nodes.size() - 1; i >= 0; i--) {
+        QuadNode& n = nodes[i];
+        float m = 0.0f, mx = 0.0f, my = 0.0f;
+        if (n.firstChild < 0) {
+            for (int j = n.begin; j < n.end; j++) {
+                m += b.mass[j];
+                mx += b.mass[j] * b.x[j];
+                my += b.mass[j] * b.y[j];
+            }
+        } else {
+            for (int c = n.firstChild; c < n.firstChild + n.childCount; c++) {
+                m += nodes[c].mass;
+                mx += nodes[c].mass * nodes[c].cx;
+                my += nodes[c].mass * nodes[c].cy;
+            }
+        }
+        n.mass = m;
+        n.cx = (m > 0.0f) ? mx / m : b.x[n.begin];
+        n.cy = (m > 0.0f) ? my / m : b.y[n.begin];
+    }
+}
+
+void BarnesHut::Accel(const Bodies& b, int i, float& outAx, float& outAy) const {
+    const float px = b.x[i], py = b.y[i];
+    const float eps2 = softening * softening;
+    const float theta2 = theta * theta;
+    float ax = 0.0f, ay = 0.0f;
+
+    int stack[4 * (MAX_LEVEL + 2)];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const QuadNode& n = nodes[stack[--top]];
+        float dx = n.cx - px;
+        float dy = n.cy - py;
+        float d2 = dx * dx + dy * dy;
+
+        if (n.firstChild < 0) {
+            for (int j = n.begin; j < n.end; j++) {
+                if (j == i) continue;
+                float ex = b.x[j] - px;
+                float ey = b.y[j] - py;
+                float r2 = ex * ex + ey * ey + eps2;
+                float inv = 1.0f / sqrtf(r2);
+                float f = b.mass[j] * inv * inv * inv;
+                ax += f * ex;
+                ay += f * ey;
+            }
+        } else if (n.size * n.size < theta2 * d2) {
+            // Far enough away: treat the whole node as one point mass
+            float r2 = d2 + eps2;
+            float inv = 1.0f / sqrtf(r2);
+            float f = n.mass * inv * inv * inv;
+            ax += f * dx;
+            ay += f * dy;
+        } else {
+            for (int c = n.firstChild; c < n.firstChild + n.childCount; c++)
+                stack[top++] = c;
+        }
+    }
+
+    outAx = G * ax;
+    outAy = G * ay;
+}
+
+void BarnesHut::ComputeForces(Bodies& b, ThreadPool* pool) const {
+    if (nodes.empty()) return;
+
+    auto work = [&](int begin, int end, int) {
+        for (int i = begin; i < end; i++) Accel(b, i, b.ax[i], b.ay[i]);
+    };
+
+    if (pool) pool->ParallelFor(b.Size(), work);
+    else work(0, b.Size(), 0);
+}
+
+void DirectSum(const Bodies& b, float G, float softening, const std::vector<int>& which,
+               std::vector<float>& outAx, std::vector<float>& outAy) {
+    const float eps2 = softening * softening;
+    int n = b.Size();
+    outAx.assign(which.size(), 0.0f);
+    outAy.assign(which.size(), 0.0f);
+
+    for (size_t k = 0; k < which.size(); k++) {
+        int i = which[k];
+        float px = b.x[i], py = b.y[i];
+        double ax = 0.0, ay = 0.0;
+        for (int j = 0; j < n; j++) {
+            if (j == i) continue;
+            float ex = b.x[j] - px;
+            float ey = b.y[j] - py;
+            float r2 = ex * ex + ey * ey + eps2;
+            float inv = 1.0f / sqrtf(r2);
+            float f = b.mass[j] * inv * inv * inv;
+            ax += f * ex;
+            ay += f * ey;
+        }
+        outAx[k] = (float)(G * ax);
+        outAy[k] = (float)(G * ay);
+    }
+}
+
+void Integrate(Bodies& b, float dt) {
+    int n = b.Size();
+    for (int i = 0; i < n; i++) {
+        b.vx[i] += b.ax[i] * dt;
+        b.vy[i] += b.ay[i] * dt;
+        b.x[i] += b.vx[i] * dt;
+        b.y[i] += b.vy[i] * dt;
+    }
+}
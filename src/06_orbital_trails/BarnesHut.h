@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+// Structure-of-arrays body storage for the n-body mode.
+// Build() reorders every array into Morton order, so indices are only
+// stable between two builds.
+struct Bodies {
+    std::vector<float> x, y;
+    std::vector<float> vx, vy;
+    std::vector<float> ax, ay;
+    std::vector<float> mass;
+
+    int Size() const { return (int)x.size(); }
+    void Resize(int n);
+};
+
+// Quadtree node over a contiguous range of Morton-sorted bodies
+struct QuadNode {
+    float cx, cy;     // centre of mass
+    float mass;       // total mass
+    float size;       // side length of the node's square
+    int firstChild;   // children are stored contiguously, -1 for leaves
+    int childCount;
+    int begin, end;   // body range [begin, end)
+};
+
+class BarnesHut {
+public:
+    float theta = 0.5f;      // opening angle: 0 = exact, larger = faster and coarser
+    float G = 1.0f;
+    float softening = 2.0f;  // Plummer softening length in pixels
+    int leafSize = 8;        // max bodies per leaf
+
+    // Sort the bodies by Morton code and rebuild the tree from scratch
+    void Build(Bodies& bodies);
+
+    // Fill bodies.ax / bodies.ay, optionally split across a worker pool
+    void ComputeForces(Bodies& bodies, ThreadPool* pool = nullptr) const;
+
+    // Acceleration at body i from the tree (i is skipped in leaves)
+    void Accel(const Bodies& bodies, int i, float& ax, float& ay) const;
+
+    const std::vector<QuadNode>& Nodes() const { return nodes; }
+
+private:
+    std::vector<QuadNode> nodes;
+    std::vector<uint32_t> codes, order, codesTmp, orderTmp;
+    std::vector<float> scratch;
+
+    float SortByMorton(Bodies& bodies);   // returns the root square size
+    void BuildNode(int index, int begin, int end, int level, float size);
+};
+
+// O(n^2) reference: accelerations of the listed bodies from every body
+void DirectSum(const Bodies& bodies, float G, float softening, const std::vector<int>& which,
+               std::vector<float>& ax, std::vector<float>& ay);
+
+// Semi-implicit Euler step using the current accelerations
+void Integrate(Bodies& bodies, float dt);
@@ -0,0 +1,90 @@
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Small fixed-size worker pool.
+// ParallelFor splits [0, count) into one contiguous chunk per worker and
+// blocks until all chunks are done. The calling thread runs chunk 0, so a
+// pool of size 1 never touches another thread.
+class ThreadPool {
+public:
+    explicit ThreadPool(int threads = 0) {
+        if (threads <= 0) threads = (int)std::thread::hardware_concurrency();
+        if (threads <= 0) threads = 1;
+        for (int i = 1; i < threads; i++)
+            workers.emplace_back([this, i] { WorkerLoop(i); });
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            quit = true;
+        }
+        wake.notify_all();
+        for (auto& t : workers) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int Size() const { return (int)workers.size() + 1; }
+
+    // fn(begin, end, worker) is called once per non-empty chunk
+    void ParallelFor(int count, const std::function<void(int, int, int)>& fn) {
+        if (count <= 0) return;
+        int n = Size();
+        if (n == 1 || count == 1) { fn(0, count, 0); return; }
+
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            job = &fn;
+            jobCount = count;
+            pending = n - 1;
+            generation++;
+        }
+        wake.notify_all();
+
+        RunChunk(0);
+
+        std::unique_lock<std::mutex> lock(mtx);
+        done.wait(lock, [this] { return pending == 0; });
+        job = nullptr;
+    }
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex mtx;
+    std::condition_variable wake, done;
+    const std::function<void(int, int, int)>* job = nullptr;
+    int jobCount = 0;
+    int pending = 0;
+    unsigned generation = 0;
+    bool quit = false;
+
+    void RunChunk(int worker) {
+        int n = Size();
+        int begin = (int)((long long)jobCount * worker / n);
+        int end   = (int)((long long)jobCount * (worker + 1) / n);
+        if (begin < end) (*job)(begin, end, worker);
+    }
+
+    void WorkerLoop(int worker) {
+        unsigned seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                wake.wait(lock, [&] { return quit || generation != seen; });
+                if (quit) return;
+                seen = generation;
+            }
+            RunChunk(worker);
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                if (--pending == 0) done.notify_one();
+            }
+        }
+    }
+};
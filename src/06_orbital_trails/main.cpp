@@ -1,10 +1,16 @@
 #include <raylib.h>
 #include <random>
 #include <vector>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
 
 #include <iostream>
 #include <iomanip>
 
+#include "BarnesHut.h"
+#include "ThreadPool.h"
+
 using namespace std;
 
 struct Orbit
@@ -62,7 +68,118 @@ Color HSLtoRGB(float h, float s, float l) {
     };
 }
 
-int main() {
+// Place body i on a roughly circular orbit around (cx, cy).
+// enclosedMass is the mass assumed to sit inside radius r.
+void SeedOrbit(Bodies& bodies, int i, float cx, float cy,
+               float angle, float r, float m, float enclosedMass, float G) {
+    float v = sqrtf(G * enclosedMass / r);
+    bodies.x[i] = cx + cosf(angle) * r;
+    bodies.y[i] = cy + sinf(angle) * r;
+    bodies.vx[i] = -sinf(angle) * v;
+    bodies.vy[i] =  cosf(angle) * v;
+    bodies.mass[i] = m;
+    bodies.ax[i] = bodies.ay[i] = 0.0f;
+}
+
+// n orbs on a disc plus one heavy body in the middle (stored last)
+void SeedDisc(Bodies& bodies, int n, float cx, float cy, float minR, float maxR,
+              float centralMass, float G) {
+    bodies.Resize(n + 1);
+    float orbMass = 1.0f;
+    float totalOrbMass = orbMass * n;
+    for (int i = 0; i < n; i++) {
+        float r = Rand(minR, maxR);
+        float enclosed = centralMass + totalOrbMass * (r - minR) / (maxR - minR);
+        SeedOrbit(bodies, i, cx, cy, Rand(0.0f, PI * 2.0f), r, orbMass * Rand(0.5f, 1.5f), enclosed, G);
+    }
+    SeedOrbit(bodies, n, cx, cy, 0.0f, 1.0f, centralMass, 0.0f, G);
+}
+
+double MillisSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Headless profiling run: tree build, force pass per theta and per thread
+// count, and error against the direct-sum reference on a random sample.
+int RunBenchmark(int numBodies, int maxThreads) {
+    const float G = 1.0f;
+    Bodies bodies;
+    SeedDisc(bodies, numBodies, 0.0f, 0.0f, 20.0f, 2000.0f, 1000.0f, G);
+    int n = bodies.Size();
+
+    BarnesHut tree;
+    tree.G = G;
+
+    const int reps = 3;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; r++) tree.Build(bodies);
+    double buildMs = MillisSince(start) / reps;
+
+    cout << "bodies " << n << ", nodes " << tree.Nodes().size() << "\n";
+    cout << "morton sort + build: " << fixed << setprecision(2) << buildMs << " ms\n";
+
+    // Direct-sum reference on a sample (everything for small n)
+    vector<int> sample;
+    if (n <= 2048) {
+        for (int i = 0; i < n; i++) sample.push_back(i);
+    } else {
+        mt19937 engine{1234};
+        uniform_int_distribution<int> pick(0, n - 1);
+        for (int i = 0; i < 512; i++) sample.push_back(pick(engine));
+    }
+    vector<float> refAx, refAy;
+    start = std::chrono::steady_clock::now();
+    DirectSum(bodies, G, tree.softening, sample, refAx, refAy);
+    double directPerBody = MillisSince(start) / sample.size();
+    cout << "direct sum: " << setprecision(4) << directPerBody << " ms/body, "
+         << setprecision(1) << directPerBody * n << " ms for all (estimated)\n";
+
+    cout << "\ntheta   force ms   rel rms err   (1 thread)\n";
+    for (float theta : { 0.25f, 0.5f, 0.75f, 1.0f }) {
+        tree.theta = theta;
+        start = std::chrono::steady_clock::now();
+        tree.ComputeForces(bodies);
+        double ms = MillisSince(start);
+
+        double errSq = 0.0, refSq = 0.0;
+        for (size_t k = 0; k < sample.size(); k++) {
+            int i = sample[k];
+            double ex = bodies.ax[i] - refAx[k];
+            double ey = bodies.ay[i] - refAy[k];
+            errSq += ex * ex + ey * ey;
+            refSq += (double)refAx[k] * refAx[k] + (double)refAy[k] * refAy[k];
+        }
+        cout << setprecision(2) << theta << "    " << setw(8) << ms << "   "
+             << scientific << setprecision(3) << sqrt(errSq / refSq) << fixed << "\n";
+    }
+
+    tree.theta = 0.5f;
+    cout << "\nthreads  force ms  speedup   (theta 0.5)\n";
+    vector<int> threadCounts;
+    for (int t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    double baseMs = 0.0;
+    for (int t : threadCounts) {
+        ThreadPool pool(t);
+        start = std::chrono::steady_clock::now();
+        for (int r = 0; r < reps; r++) tree.ComputeForces(bodies, &pool);
+        double ms = MillisSince(start) / reps;
+        if (t == 1) baseMs = ms;
+        cout << setw(7) << t << "  " << setw(8) << setprecision(2) << ms
+             << "  " << setw(6) << baseMs / ms << "x\n";
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    // orbital_trails --bench [bodies] [threads]
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        int numBodies = (argc > 2) ? atoi(argv[2]) : 100000;
+        int threads = (argc > 3) ? atoi(argv[3]) : (int)std::thread::hardware_concurrency();
+        return RunBenchmark(numBodies, threads > 0 ? threads : 1);
+    }
+
     const int screenWidth  = 800;
     const int screenHeight = 450;
     const int numOrbs = 300;
@@ -91,10 +208,76 @@ int main() {
         orbits.push_back(orbit);
     }
 
+    // N-body mode: the same orbs attract each other and a heavy centre body
+    const float G = 1.0f;
+    const float centralMass = 1000.0f;
+    bool nbody = false;
+    bool threaded = false;
+    Bodies bodies;
+    BarnesHut tree;
+    tree.G = G;
+    ThreadPool pool;
+    vector<float> lastX, lastY;
+    double forceMs = 0.0;
+
     while (!WindowShouldClose()) {
+        // N = toggle n-body mode, T = toggle threaded force pass, UP/DOWN = theta
+        if (IsKeyPressed(KEY_N)) {
+            nbody = !nbody;
+            if (nbody) {
+                bodies.Resize(numOrbs + 1);
+                float totalMass = 0.0f;
+                for (auto& orbit : orbits) totalMass += orbit.size;
+                for (int i = 0; i < numOrbs; i++) {
+                    const Orbit& o = orbits[i];
+                    float enclosed = centralMass + totalMass * o.radius / maxRadius;
+                    SeedOrbit(bodies, i, o.centerX, o.centerY, o.angle, o.radius, o.size, enclosed, G);
+                }
+                SeedOrbit(bodies, numOrbs, screenWidth / 2.0f, screenHeight / 2.0f,
+                          0.0f, 1.0f, centralMass, 0.0f, G);
+            }
+        }
+        if (IsKeyPressed(KEY_T)) threaded = !threaded;
+        if (IsKeyPressed(KEY_UP))   tree.theta = fminf(tree.theta + 0.1f, 2.0f);
+        if (IsKeyPressed(KEY_DOWN)) tree.theta = fmaxf(tree.theta - 0.1f, 0.0f);
+
         BeginDrawing();
 
         DrawRectangle(0, 0, screenWidth, screenHeight, {0, 0, 0, 25});
+
+        if (nbody) {
+            auto start = std::chrono::steady_clock::now();
+            tree.Build(bodies);
+            tree.ComputeForces(bodies, threaded ? &pool : nullptr);
+            forceMs = MillisSince(start);
+
+            lastX = bodies.x;
+            lastY = bodies.y;
+            Integrate(bodies, 1.0f);
+
+            for (int i = 0; i < bodies.Size(); i++) {
+                if (bodies.mass[i] >= centralMass) continue;
+
+                float a = atan2f(bodies.y[i] - screenHeight / 2.0f, bodies.x[i] - screenWidth / 2.0f);
+                float hue = fmodf(a * 180.0f / PI + 360.0f, 360.0f);
+                Color col = HSLtoRGB(hue, 1.0f, 0.5f);
+
+                DrawLineEx(
+                    { lastX[i], lastY[i] },
+                    { bodies.x[i], bodies.y[i] },
+                    bodies.mass[i],
+                    col
+                );
+            }
+
+            DrawRectangle(5, 5, 260, 22, BLACK);
+            DrawText(TextFormat("theta %.1f  %s  %.2f ms", tree.theta,
+                                threaded ? "threaded" : "1 thread", forceMs),
+                     10, 10, 16, RAYWHITE);
+            EndDrawing();
+            continue;
+        }
+
         for (auto& orbit : orbits) {
             orbit.lastX = orbit.x;
             orbit.lastY = orbit.y;
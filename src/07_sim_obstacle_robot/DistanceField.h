@@ -0,0 +1,38 @@
+#pragma once
+#include <raylib.h>
+#include <vector>
+
+// Euclidean distance transform of a map (black pixels are walls), built
+// once at load time with Felzenszwalb & Huttenlocher's linear-time
+// algorithm. Rays sphere-trace it: in open space they jump ahead by the
+// free distance, near walls they fall back to exact cell-by-cell steps.
+class DistanceField {
+public:
+    DistanceField() = default;
+    explicit DistanceField(const Image& map);
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+
+    // Distance from this cell's centre to the nearest wall cell centre
+    // (0 inside walls). Out-of-bounds cells return 0.
+    float At(int x, int y) const {
+        if ((unsigned)x >= (unsigned)width || (unsigned)y >= (unsigned)height) return 0.0f;
+        return dist[y * width + x];
+    }
+
+    bool IsWall(int x, int y) const {
+        if ((unsigned)x >= (unsigned)width || (unsigned)y >= (unsigned)height) return false;
+        return dist[y * width + x] == 0.0f;
+    }
+
+    // Same contract as a grid DDA: distance at which the ray enters the
+    // first wall cell, false if nothing is hit within range. Angle uses
+    // the screen convention, direction (cos a, -sin a). steps (optional)
+    // receives the number of loop iterations taken.
+    bool CastRay(Vector2 origin, float angle, float range, float& hitDistance, int* steps = nullptr) const;
+
+private:
+    int width = 0, height = 0;
+    std::vector<float> dist;
+};
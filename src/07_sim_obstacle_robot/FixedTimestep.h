@@ -0,0 +1,29 @@
+#pragma once
+
+// Fixed-timestep accumulator: the simulation always advances in steps of
+// exactly dt, however long the rendered frames take. Alpha() tells the
+// renderer how far the current time sits between the last two steps.
+class FixedTimestep {
+public:
+    explicit FixedTimestep(double hz, double maxFrameTime = 0.25)
+        : dt(1.0 / hz), maxFrame(maxFrameTime) {}
+
+    double Dt() const { return dt; }
+
+    // Add one frame's time and return how many steps to run. Long frames
+    // are clamped so a stall cannot trigger an endless catch-up.
+    int Advance(double frameTime) {
+        if (frameTime > maxFrame) frameTime = maxFrame;
+        accumulator += frameTime;
+        int steps = (int)(accumulator / dt);
+        accumulator -= steps * dt;
+        return steps;
+    }
+
+    float Alpha() const { return (float)(accumulator / dt); }
+
+private:
+    double dt;
+    double maxFrame;
+    double accumulator = 0.0;
+};
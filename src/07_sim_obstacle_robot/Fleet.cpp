@@ -0,0 +1,49 @@
+#include "Fleet.h"
+#include "DistanceField.h"
+#include "ThreadPool.h"
+#include <random>
+
+void Fleet::Spawn(int count, const DistanceField& field, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> rx(0, field.Width()), ry(0, field.Height()), rh(0, 2 * PI);
+
+    x.resize(count); y.resize(count); heading.resize(count);
+    vl.assign(count, config.params.minSpeed);
+    vr.assign(count, config.params.minSpeed);
+    countDown.assign(count, config.params.backupTime);
+    for (int i = 0; i < count; i++) {
+        do { x[i] = rx(gen); y[i] = ry(gen); } while (field.At((int)x[i], (int)y[i]) < 5.0f);
+        heading[i] = rh(gen);
+    }
+}
+
+float ClosestObstacle(const DistanceField& field, Vector2 pos, float heading,
+                      float range, float fov, int rayCount) {
+    float startAngle = heading - fov;
+    float endAngle = heading + fov;
+    float closest = std::numeric_limits<float>::max();
+    for (int r = 0; r < rayCount; r++) {
+        float angle = LerpFloat(startAngle, endAngle, r / (float)rayCount);
+        float hit;
+        if (field.CastRay(pos, angle, range, hit) && hit < closest) closest = hit;
+    }
+    return closest;
+}
+
+float Fleet::ClosestObstacle(int i, const DistanceField& field) const {
+    return ::ClosestObstacle(field, {x[i], y[i]}, heading[i], config.range, config.fov, config.rayCount);
+}
+
+void Fleet::StepRange(int begin, int end, float dt, const DistanceField& field) {
+    const RobotParams& p = config.params;
+    for (int i = begin; i < end; i++) {
+        float closest = ClosestObstacle(i, field);
+        AvoidStep(closest, p.minObsDist, p.minSpeed, p.backupTime, countDown[i], vl[i], vr[i], dt);
+        DiffDriveStep(x[i], y[i], heading[i], vl[i], vr[i], config.width, p.maxSpeed, dt);
+    }
+}
+
+void Fleet::Step(float dt, const DistanceField& field, ThreadPool* pool) {
+    if (pool) pool->ParallelFor(Size(), [&](int begin, int end, int) { StepRange(begin, end, dt, field); });
+    else StepRange(0, Size(), dt, field);
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "raylib.h"
+#include <vector>
+#include "Robot.h"
+
+class DistanceField;
+class ThreadPool;
+
+// Behaviour and sensor settings shared by every robot of a fleet
+struct FleetConfig {
+    float width = 40.0f;
+    RobotParams params;
+    float range = 250.0f;
+    float fov = DEG2RAD * 40;
+    int rayCount = 10;
+};
+
+// Closest hit of a rayCount fan spanning heading +- fov, the same fan as
+// SenseObstacles (max float if nothing is within range)
+float ClosestObstacle(const DistanceField& field, Vector2 pos, float heading,
+                      float range, float fov, int rayCount);
+
+// Many robots in structure-of-arrays form, stepped headlessly on a fixed
+// timestep. Each step runs the same sense / avoid / kinematics rules as
+// Robot, against a shared read-only distance field. Robots never interact,
+// so the step splits cleanly across a thread pool.
+class Fleet {
+public:
+    FleetConfig config;
+    std::vector<float> x, y, heading;
+    std::vector<float> vl, vr;
+    std::vector<float> countDown;
+
+    int Size() const { return (int)x.size(); }
+
+    // Random free poses, at least 5 px from any wall
+    void Spawn(int count, const DistanceField& field, unsigned seed);
+
+    // Advance every robot by dt; pool may be null
+    void Step(float dt, const DistanceField& field, ThreadPool* pool = nullptr);
+
+    // Distance to the closest hit of robot i's sensor fan (max float if none)
+    float ClosestObstacle(int i, const DistanceField& field) const;
+
+private:
+    void StepRange(int begin, int end, float dt, const DistanceField& field);
+};
@@ -0,0 +1,341 @@
+#include "Planner.h"
+#include "DistanceField.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+static double MicrosSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+static const float SQRT2 = 1.41421356f;
+
+// Exact length of the cheapest 8-connected move sequence between two cells
+static inline float Octile(int dx, int dy) {
+    dx = std::abs(dx); dy = std::abs(dy);
+    return (float)(dx + dy) + (SQRT2 - 2.0f) * (float)std::min(dx, dy);
+}
+
+static inline int Sign(int v) { return (v > 0) - (v < 0); }
+
+static inline bool HeapLess(const PlanNode& a, const PlanNode& b) { return a.f > b.f; }
+
+void PlanLayer::Resize(int w, int h) {
+    width = w; height = h;
+    blocked.assign((size_t)w * h, 0);
+    g.assign((size_t)w * h, 0.0f);
+    parent.assign((size_t)w * h, -1);
+    opened.assign((size_t)w * h, 0);
+    closed.assign((size_t)w * h, 0);
+    generation = 0;
+    heap.clear();
+    heap.reserve((size_t)w * h / 8 + 64);
+}
+
+void GridPlanner::Build(const DistanceField& field, float radius, int coarseShift) {
+    shift = coarseShift;
+    fine.Resize(field.Width(), field.Height());
+    for (int y = 0; y < fine.height; y++)
+        for (int x = 0; x < fine.width; x++)
+            fine.blocked[y * fine.width + x] = field.At(x, y) < radius;
+
+    // A coarse cell is open if any of its pixels is; the fine search is the
+    // one that decides whether the route really fits
+    int cell = 1 << shift;
+    coarse.Resize((fine.width + cell - 1) >> shift, (fine.height + cell - 1) >> shift);
+    std::fill(coarse.blocked.begin(), coarse.blocked.end(), 1);
+    for (int y = 0; y < fine.height; y++)
+        for (int x = 0; x < fine.width; x++)
+            if (!fine.blocked[y * fine.width + x])
+                coarse.blocked[(y >> shift) * coarse.width + (x >> shift)] = 0;
+
+    corridor.assign(coarse.blocked.size(), 0);
+    corridorGeneration = 0;
+    restrict = false;
+}
+
+size_t GridPlanner::MemoryBytes() const {
+    auto layer = [](const PlanLayer& l) {
+        return l.blocked.capacity() + l.g.capacity() * sizeof(float) + l.parent.capacity() * sizeof(int) +
+               (l.opened.capacity() + l.closed.capacity()) * sizeof(uint32_t) + l.heap.capacity() * sizeof(PlanNode);
+    };
+    return layer(fine) + layer(coarse) + corridor.capacity() * sizeof(uint32_t);
+}
+
+bool GridPlanner::NearestFree(Vector2 p, Vector2& out, int maxRadius) const {
+    int cx = (int)p.x, cy = (int)p.y;
+    for (int r = 0; r <= maxRadius; r++) {
+        // Walk the square ring at Chebyshev distance r, keep the closest free cell
+        float best = 1e30f;
+        for (int y = cy - r; y <= cy + r; y++) {
+            int step = (y == cy - r || y == cy + r) ? 1 : 2 * r;
+            for (int x = cx - r; x <= cx + r; x += (step > 0 ? step : 1)) {
+                if (fine.Blocked(x, y)) continue;
+                float d = (float)((x - cx) * (x - cx) + (y - cy) * (y - cy));
+                if (d < best) { best = d; out = { x + 0.5f, y + 0.5f }; }
+            }
+        }
+        if (best < 1e30f) return true;
+    }
+    return false;
+}
+
+bool GridPlanner::Snap(Vector2 p, int& index) const {
+    Vector2 q = p;
+    if (fine.Blocked((int)p.x, (int)p.y) && !NearestFree(p, q)) return false;
+    index = (int)q.y * fine.width + (int)q.x;
+    return true;
+}
+
+// Walk from (x, y) in direction (dx, dy) until the goal, a wall, or a cell
+// with a forced neighbour. Diagonal moves may not cut wall corners, which
+// is the variant where only straight moves have forced neighbours.
+int GridPlanner::Jump(int x, int y, int dx, int dy, int goal) const {
+    const int w = fine.width;
+    for (;;) {
+        x += dx; y += dy;
+        if (!Free(x, y)) return -1;
+        int index = y * w + x;
+        if (index == goal) return index;
+
+        if (dx != 0 && dy != 0) {
+            if (JumpStraight(x, y, dx, 0, goal) || JumpStraight(x, y, 0, dy, goal)) return index;
+            if (!Free(x + dx, y) || !Free(x, y + dy)) return -1;
+        } else if (dx != 0) {
+            if ((Free(x, y - 1) && !Free(x - dx, y - 1)) || (Free(x, y + 1) && !Free(x - dx, y + 1))) return index;
+        } else {
+            if ((Free(x - 1, y) && !Free(x - 1, y - dy)) || (Free(x + 1, y) && !Free(x + 1, y - dy))) return index;
+        }
+    }
+}
+
+bool GridPlanner::JumpStraight(int x, int y, int dx, int dy, int goal) const {
+    return Jump(x, y, dx, dy, goal) >= 0;
+}
+
+bool GridPlanner::SearchFine(int start, int goal, bool jump, int& expanded) {
+    PlanLayer& L = fine;
+    const int w = L.width;
+    if (++L.generation == 0) {
+        std::fill(L.opened.begin(), L.opened.end(), 0);
+        std::fill(L.closed.begin(), L.closed.end(), 0);
+        L.generation = 1;
+    }
+    const uint32_t gen = L.generation;
+    const int gx = goal % w, gy = goal / w;
+
+    L.heap.clear();
+    L.g[start] = 0.0f;
+    L.parent[start] = -1;
+    L.opened[start] = gen;
+    L.heap.push_back({ Octile(gx - start % w, gy - start / w), start });
+
+    while (!L.heap.empty()) {
+        std::pop_heap(L.heap.begin(), L.heap.end(), HeapLess);
+        int current = L.heap.back().index;
+        L.heap.pop_back();
+        if (L.closed[current] == gen) continue;
+        L.closed[current] = gen;
+        expanded++;
+        if (current == goal) return true;
+
+        int x = current % w, y = current / w;
+
+        // Directions to try. JPS prunes them by the direction of arrival;
+        // a diagonal is only allowed when both cells beside it are free.
+        int dirs[8][2];
+        int count = 0;
+        int p = L.parent[current];
+        if (jump && p >= 0) {
+            int dx = Sign(x - p % w), dy = Sign(y - p / w);
+            if (dx != 0 && dy != 0) {
+                bool vertical = Free(x, y + dy), horizontal = Free(x + dx, y);
+                if (vertical) { dirs[count][0] = 0; dirs[count][1] = dy; count++; }
+                if (horizontal) { dirs[count][0] = dx; dirs[count][1] = 0; count++; }
+                if (vertical && horizontal) { dirs[count][0] = dx; dirs[count][1] = dy; count++; }
+            } else if (dx != 0) {
+                bool next = Free(x + dx, y), down = Free(x, y + 1), up = Free(x, y - 1);
+                if (next) {
+                    dirs[count][0] = dx; dirs[count][1] = 0; count++;
+                    if (down) { dirs[count][0] = dx; dirs[count][1] = 1; count++; }
+                    if (up) { dirs[count][0] = dx; dirs[count][1] = -1; count++; }
+                }
+                if (down) { dirs[count][0] = 0; dirs[count][1] = 1; count++; }
+                if (up) { dirs[count][0] = 0; dirs[count][1] = -1; count++; }
+            } else {
+                bool next = Free(x, y + dy), left = Free(x - 1, y), right = Free(x + 1, y);
+                if (next) {
+                    dirs[count][0] = 0; dirs[count][1] = dy; count++;
+                    if (left) { dirs[count][0] = -1; dirs[count][1] = dy; count++; }
+                    if (right) { dirs[count][0] = 1; dirs[count][1] = dy; count++; }
+                }
+                if (left) { dirs[count][0] = -1; dirs[count][1] = 0; count++; }
+                if (right) { dirs[count][0] = 1; dirs[count][1] = 0; count++; }
+            }
+        } else {
+            for (int dy = -1; dy <= 1; dy++)
+                for (int dx = -1; dx <= 1; dx++) {
+                    if (dx == 0 && dy == 0) continue;
+                    if (!Free(x + dx, y + dy)) continue;
+                    if (dx != 0 && dy != 0 && (!Free(x + dx, y) || !Free(x, y + dy))) continue;
+                    dirs[count][0] = dx; dirs[count][1] = dy; count++;
+                }
+        }
+
+        for (int k = 0; k < count; k++) {
+            int next = jump ? Jump(x, y, dirs[k][0], dirs[k][1], goal)
+                            : (y + dirs[k][1]) * w + x + dirs[k][0];
+            if (next < 0 || L.closed[next] == gen) continue;
+
+            int nx = next % w, ny = next / w;
+            float g = L.g[current] + Octile(nx - x, ny - y);
+            if (L.opened[next] != gen || g < L.g[next]) {
+                L.opened[next] = gen;
+                L.g[next] = g;
+                L.parent[next] = current;
+                L.heap.push_back({ g + Octile(gx - nx, gy - ny), next });
+                std::push_heap(L.heap.begin(), L.heap.end(), HeapLess);
+            }
+        }
+    }
+    return false;
+}
+
+// Plain A* on the coarse grid; costs are in coarse cells
+bool GridPlanner::SearchCoarse(int start, int goal, int& expanded) {
+    PlanLayer& L = coarse;
+    const int w = L.width;
+    if (++L.generation == 0) {
+        std::fill(L.opened.begin(), L.opened.end(), 0);
+        std::fill(L.closed.begin(), L.closed.end(), 0);
+        L.generation = 1;
+    }
+    const uint32_t gen = L.generation;
+    const int gx = goal % w, gy = goal / w;
+
+    L.heap.clear();
+    L.g[start] = 0.0f;
+    L.parent[start] = -1;
+    L.opened[start] = gen;
+    L.heap.push_back({ Octile(gx - start % w, gy - start / w), start });
+
+    while (!L.heap.empty()) {
+        std::pop_heap(L.heap.begin(), L.heap.end(), HeapLess);
+        int current = L.heap.back().index;
+        L.heap.pop_back();
+        if (L.closed[current] == gen) continue;
+        L.closed[current] = gen;
+        expanded++;
+        if (current == goal) return true;
+
+        int x = current % w, y = current / w;
+        for (int dy = -1; dy <= 1; dy++)
+            for (int dx = -1; dx <= 1; dx++) {
+                if (dx == 0 && dy == 0) continue;
+                int nx = x + dx, ny = y + dy;
+                if (L.Blocked(nx, ny)) continue;
+                if (dx != 0 && dy != 0 && (L.Blocked(x + dx, y) || L.Blocked(x, y + dy))) continue;
+                int next = ny * w + nx;
+                if (L.closed[next] == gen) continue;
+
+                float g = L.g[current] + Octile(dx, dy);
+                if (L.opened[next] != gen || g < L.g[next]) {
+                    L.opened[next] = gen;
+                    L.g[next] = g;
+                    L.parent[next] = current;
+                    L.heap.push_back({ g + Octile(gx - nx, gy - ny), next });
+                    std::push_heap(L.heap.begin(), L.heap.end(), HeapLess);
+                }
+            }
+    }
+    return false;
+}
+
+// Cell centres from start to goal, keeping only the corners. Returns the
+// path length.
+float GridPlanner::Extract(int start, int goal, std::vector<Vector2>& path) const {
+    const int w = fine.width;
+    path.clear();
+    for (int c = goal; ; c = fine.parent[c]) {
+        path.push_back({ c % w + 0.5f, c / w + 0.5f });
+        if (c == start) break;
+    }
+    std::reverse(path.begin(), path.end());
+
+    // Every segment is straight or diagonal, so equal signs mean collinear
+    auto dir = [](Vector2 a, Vector2 b) { return Sign((int)(b.x - a.x)) * 3 + Sign((int)(b.y - a.y)); };
+    size_t kept = 1;
+    for (size_t i = 1; i + 1 < path.size(); i++)
+        if (dir(path[kept - 1], path[i]) != dir(path[i], path[i + 1])) path[kept++] = path[i];
+    if (path.size() > 1) path[kept++] = path.back();
+    path.resize(kept);
+    return fine.g[goal];
+}
+
+bool GridPlanner::FindPath(Vector2 start, Vector2 goal, std::vector<Vector2>& path, PlanStats* stats) {
+    auto t0 = std::chrono::steady_clock::now();
+    PlanStats s;
+    int from, to;
+    bool found = Snap(start, from) && Snap(goal, to) && SearchFine(from, to, true, s.expanded);
+    if (found) s.cost = Extract(from, to, path);
+    else path.clear();
+    s.micros = MicrosSince(t0);
+    if (stats) *stats = s;
+    return found;
+}
+
+bool GridPlanner::FindPathAStar(Vector2 start, Vector2 goal, std::vector<Vector2>& path, PlanStats* stats) {
+    auto t0 = std::chrono::steady_clock::now();
+    PlanStats s;
+    int from, to;
+    bool found = Snap(start, from) && Snap(goal, to) && SearchFine(from, to, false, s.expanded);
+    if (found) s.cost = Extract(from, to, path);
+    else path.clear();
+    s.micros = MicrosSince(t0);
+    if (stats) *stats = s;
+    return found;
+}
+
+bool GridPlanner::FindPathHierarchical(Vector2 start, Vector2 goal, std::vector<Vector2>& path, PlanStats* stats) {
+    auto t0 = std::chrono::steady_clock::now();
+    PlanStats s;
+    s.hierarchical = true;
+    int from, to;
+    bool found = false;
+    if (Snap(start, from) && Snap(goal, to)) {
+        const int w = fine.width;
+        int coarseFrom = ((from / w) >> shift) * coarse.width + ((from % w) >> shift);
+        int coarseTo = ((to / w) >> shift) * coarse.width + ((to % w) >> shift);
+
+        if (SearchCoarse(coarseFrom, coarseTo, s.expanded)) {
+            // Corridor: the coarse route plus one coarse cell either side
+            if (++corridorGeneration == 0) {
+                std::fill(corridor.begin(), corridor.end(), 0);
+                corridorGeneration = 1;
+            }
+            for (int c = coarseTo; c >= 0; c = coarse.parent[c]) {
+                int cx = c % coarse.width, cy = c / coarse.width;
+                for (int y = std::max(cy - 1, 0); y <= std::min(cy + 1, coarse.height - 1); y++)
+                    for (int x = std::max(cx - 1, 0); x <= std::min(cx + 1, coarse.width - 1); x++)
+                        corridor[y * coarse.width + x] = corridorGeneration;
+            }
+            restrict = true;
+            found = SearchFine(from, to, true, s.expanded);
+            restrict = false;
+        }
+        // The coarse grid is optimistic; if the corridor does not fit the
+        // robot, fall back to the full-resolution search
+        if (!found) found = SearchFine(from, to, true, s.expanded);
+        if (found) s.cost = Extract(from, to, path);
+    }
+    if (!found) path.clear();
+    s.micros = MicrosSince(t0);
+    if (stats) *stats = s;
+    return found;
+}
+
+bool GridPlanner::Plan(Vector2 start, Vector2 goal, std::vector<Vector2>& path, PlanStats* stats) {
+    float dx = goal.x - start.x, dy = goal.y - start.y;
+    if (dx * dx + dy * dy > longQuery * longQuery) return FindPathHierarchical(start, goal, path, stats);
+    return FindPath(start, goal, path, stats);
+}
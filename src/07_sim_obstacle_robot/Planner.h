@@ -0,0 +1,96 @@
+#pragma once
+#include "raylib.h"
+#include <cstdint>
+#include <vector>
+
+class DistanceField;
+
+// Per-query numbers for the HUD and --bench-plan
+struct PlanStats {
+    double micros = 0.0;      // wall time of the whole query
+    int expanded = 0;         // nodes popped from the open list (both levels)
+    float cost = 0.0f;        // path length in pixels, 0 if no path
+    bool hierarchical = false;
+};
+
+// Open list entry; stale entries are skipped when popped
+struct PlanNode {
+    float f;
+    int index;
+};
+
+// One resolution of the planner: a blocked mask plus search state that is
+// allocated once and reused. Cells are only valid for the current query
+// when their stamp matches the generation, so nothing is cleared per query.
+struct PlanLayer {
+    int width = 0, height = 0;
+    std::vector<uint8_t> blocked;
+    std::vector<float> g;
+    std::vector<int> parent;
+    std::vector<uint32_t> opened, closed;
+    uint32_t generation = 0;
+    std::vector<PlanNode> heap;
+
+    void Resize(int w, int h);
+    bool Blocked(int x, int y) const {
+        if ((unsigned)x >= (unsigned)width || (unsigned)y >= (unsigned)height) return true;
+        return blocked[y * width + x] != 0;
+    }
+};
+
+// Point-to-point path planner on the robot's map. Walls are inflated by
+// the robot's radius once at build time, so any path through free cells is
+// one the robot's centre can follow. Queries run jump point search (A*
+// that skips over symmetric paths on uniform-cost grids) on the full grid;
+// long queries first plan on a coarse grid and confine the fine search to
+// a corridor around that route.
+class GridPlanner {
+public:
+    float longQuery = 32.0f;    // straight-line distance above which Plan() goes hierarchical
+
+    // Inflate walls by radius pixels; coarse cells are 1 << coarseShift pixels wide
+    void Build(const DistanceField& field, float radius, int coarseShift = 3);
+
+    int Width() const { return fine.width; }
+    int Height() const { return fine.height; }
+    bool Blocked(int x, int y) const { return fine.Blocked(x, y); }
+
+    // Nearest free cell centre within maxRadius, for starts and goals that
+    // sit inside the inflated walls. Returns false if there is none.
+    bool NearestFree(Vector2 p, Vector2& out, int maxRadius = 40) const;
+
+    // path receives start, the jump points (corners) and goal. Every query
+    // returns an optimal 8-connected path except the hierarchical one,
+    // which is restricted to the coarse corridor.
+    bool Plan(Vector2 start, Vector2 goal, std::vector<Vector2>& path, PlanStats* stats = nullptr);
+    bool FindPath(Vector2 start, Vector2 goal, std::vector<Vector2>& path, PlanStats* stats = nullptr);
+    bool FindPathHierarchical(Vector2 start, Vector2 goal, std::vector<Vector2>& path, PlanStats* stats = nullptr);
+
+    // Plain 8-connected A*, kept as the baseline for --bench-plan
+    bool FindPathAStar(Vector2 start, Vector2 goal, std::vector<Vector2>& path, PlanStats* stats = nullptr);
+
+    size_t MemoryBytes() const;
+
+private:
+    PlanLayer fine, coarse;
+    int shift = 3;
+
+    // Coarse cells the fine search may enter; active while restrict is set
+    std::vector<uint32_t> corridor;
+    uint32_t corridorGeneration = 0;
+    bool restrict = false;
+
+    bool Free(int x, int y) const {
+        if (fine.Blocked(x, y)) return false;
+        return !restrict || corridor[(y >> shift) * coarse.width + (x >> shift)] == corridorGeneration;
+    }
+
+    int Jump(int x, int y, int dx, int dy, int goal) const;
+    bool JumpStraight(int x, int y, int dx, int dy, int goal) const;
+
+    // A* on the fine grid (jump = jump point search) or on the coarse grid
+    bool SearchFine(int start, int goal, bool jump, int& expanded);
+    bool SearchCoarse(int start, int goal, int& expanded);
+    bool Snap(Vector2 p, int& index) const;
+    float Extract(int start, int goal, std::vector<Vector2>& path) const;
+};
@@ -0,0 +1,120 @@
+#pragma once
+#include "raylib.h"
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// ---------- Helpers ----------
+inline float ClampFloat(float value, float minVal, float maxVal) {
+    if (value < minVal) return minVal;
+    if (value > maxVal) return maxVal;
+    return value;
+}
+
+inline float LerpFloat(float a, float b, float t) {
+    return a + t * (b - a);
+}
+
+inline float Vector2Dist(Vector2 a, Vector2 b) {
+    float dx = a.x - b.x;
+    float dy = a.y - b.y;
+    return sqrtf(dx * dx + dy * dy);
+}
+
+// ---------------- ROBOT ----------------
+// Controller tuning; the defaults are the original hand-picked values
+struct RobotParams {
+    float minSpeed = 40.0f;     // cruise speed, also used when backing up
+    float maxSpeed = 80.0f;     // wheel speed clamp
+    float minObsDist = 100.0f;  // back up when an obstacle is closer than this
+    float backupTime = 5.0f;    // longest time spent backing up in one go
+};
+
+// One step of the robot's behaviour, shared by Robot and the SoA fleet so
+// both follow exactly the same rules.
+
+// Back up (curving) while an obstacle is closer than minObsDist, for at
+// most backupTime seconds; otherwise drive forward
+inline void AvoidStep(float closest, float minObsDist, float minSpeed, float backupTime,
+                      float& countDown, float& vl, float& vr, float dt) {
+    if (closest < minObsDist && countDown > 0) {
+        countDown -= dt;
+        vr = -minSpeed; vl = -minSpeed * 0.5f;
+    } else {
+        countDown = backupTime;
+        vl = vr = minSpeed;
+    }
+}
+
+// Turn towards a target point at up to 2 rad/s, slowing down for sharp
+// turns so the robot pivots round corners instead of swinging wide
+inline void SeekStep(float x, float y, float heading, Vector2 target, float minSpeed, float width,
+                     float& vl, float& vr) {
+    float desired = atan2f(-(target.y - y), target.x - x);
+    float error = remainderf(desired - heading, 2 * PI);
+    float v = minSpeed * fmaxf(0.0f, cosf(error));
+    float turn = ClampFloat(3.0f * error, -2.0f, 2.0f);
+    vl = v - turn * width * 0.5f;
+    vr = v + turn * width * 0.5f;
+}
+
+// Differential drive kinematics (screen y grows downwards)
+inline void DiffDriveStep(float& x, float& y, float& heading, float& vl, float& vr,
+                          float width, float maxSpeed, float dt) {
+    float v = (vl + vr) * 0.5f;
+    x += v * cosf(heading) * dt;
+    y -= v * sinf(heading) * dt;
+    heading += (vr - vl) / width * dt;
+    heading = fmodf(heading, 2 * PI);
+
+    vl = ClampFloat(vl, -maxSpeed, maxSpeed);
+    vr = ClampFloat(vr, -maxSpeed, maxSpeed);
+}
+
+struct Robot {
+    Vector2 pos;
+    float heading;
+    float width;
+
+    float vl, vr;
+    float minSpeed, maxSpeed;
+
+    float minObsDist;
+    float backupTime;
+    float countDown;
+
+    Robot(Vector2 start, float w, const RobotParams& params = RobotParams()) {
+        pos = start;
+        heading = 0.0f;
+        width = w;
+
+        minSpeed = params.minSpeed;
+        maxSpeed = params.maxSpeed;
+        vl = vr = minSpeed;
+
+        minObsDist = params.minObsDist;
+        backupTime = params.backupTime;
+        countDown = backupTime;
+    }
+
+    void MoveForward() { vl = vr = minSpeed; }
+    void MoveBackward() { vr = -minSpeed; vl = -minSpeed * 0.5f; }
+
+    void Kinematics(float dt) {
+        DiffDriveStep(pos.x, pos.y, heading, vl, vr, width, maxSpeed, dt);
+    }
+
+    void AvoidObstacles(const std::vector<Vector2>& points, float dt) {
+        float closest = std::numeric_limits<float>::max();
+        for (auto& p : points) {
+            float d = Vector2Dist(pos, p);
+            if (d < closest) closest = d;
+        }
+        AvoidStep(closest, minObsDist, minSpeed, backupTime, countDown, vl, vr, dt);
+    }
+
+    void SeekTarget(Vector2 target) {
+        SeekStep(pos.x, pos.y, heading, target, minSpeed, width, vl, vr);
+        countDown = backupTime;
+    }
+};
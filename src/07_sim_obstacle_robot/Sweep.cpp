@@ -0,0 +1,75 @@
+#include "Sweep.h"
+#include "DistanceField.h"
+#include "Fleet.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <cstdio>
+
+std::vector<SweepRun> MakeSweepGrid(const std::vector<float>& minSpeeds,
+                                   const std::vector<float>& maxSpeeds,
+                                   const std::vector<float>& minObsDists,
+                                   const std::vector<float>& backupTimes,
+                                   const std::vector<Vector2>& starts,
+                                   const std::vector<float>& startHeadings) {
+    std::vector<SweepRun> runs;
+    for (float minSpeed : minSpeeds)
+    for (float maxSpeed : maxSpeeds)
+    for (float minObsDist : minObsDists)
+    for (float backupTime : backupTimes)
+    for (size_t s = 0; s < starts.size(); s++) {
+        SweepRun run;
+        run.params = {minSpeed, maxSpeed, minObsDist, backupTime};
+        run.start = starts[s];
+        run.startHeading = startHeadings[s];
+        runs.push_back(run);
+    }
+    return runs;
+}
+
+void SimulateRun(SweepRun& run, const DistanceField& field, float seconds, float dt, float width) {
+    const RobotParams& p = run.params;
+    float x = run.start.x, y = run.start.y, heading = run.startHeading;
+    float vl = p.minSpeed, vr = p.minSpeed, countDown = p.backupTime;
+    bool touching = false;
+    const FleetConfig sensor;   // default sensor fan
+
+    long steps = (long)(seconds / dt);
+    for (long s = 0; s < steps; s++) {
+        float closest = ClosestObstacle(field, {x, y}, heading, sensor.range, sensor.fov, sensor.rayCount);
+        AvoidStep(closest, p.minObsDist, p.minSpeed, p.backupTime, countDown, vl, vr, dt);
+
+        float v = (vl + vr) * 0.5f;
+        run.distance += fabsf(v) * dt;
+        if (v < 0) run.backingTime += dt;
+
+        DiffDriveStep(x, y, heading, vl, vr, width, p.maxSpeed, dt);
+
+        // A collision is the body starting to overlap a wall
+        bool now = field.At((int)x, (int)y) < width * 0.5f;
+        if (now && !touching) run.collisions++;
+        touching = now;
+    }
+}
+
+void RunSweep(std::vector<SweepRun>& runs, const DistanceField& field, float seconds, float dt, ThreadPool& pool) {
+    // Runs vary in cost (sphere tracing is cheap in open space), so each
+    // worker pulls the next run from a shared counter instead of taking a
+    // fixed slice
+    std::atomic<int> next(0);
+    pool.ParallelFor(pool.Size(), [&](int, int, int) {
+        for (int i = next++; i < (int)runs.size(); i = next++)
+            SimulateRun(runs[i], field, seconds, dt);
+    });
+}
+
+bool WriteSweepCsv(const char* filename, const std::vector<SweepRun>& runs) {
+    FILE* f = fopen(filename, "w");
+    if (!f) return false;
+    fprintf(f, "minSpeed,maxSpeed,minObsDist,backupTime,startX,startY,startHeading,collisions,distance,backingTime\n");
+    for (auto& r : runs)
+        fprintf(f, "%g,%g,%g,%g,%.1f,%.1f,%.3f,%d,%.1f,%.2f\n",
+                r.params.minSpeed, r.params.maxSpeed, r.params.minObsDist, r.params.backupTime,
+                r.start.x, r.start.y, r.startHeading, r.collisions, r.distance, r.backingTime);
+    fclose(f);
+    return true;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "raylib.h"
+#include <vector>
+#include "Robot.h"
+
+class DistanceField;
+class ThreadPool;
+
+// One headless run of the avoidance controller with a given tuning
+struct SweepRun {
+    RobotParams params;
+    Vector2 start;
+    float startHeading;
+
+    // Metrics
+    int collisions = 0;        // times the body (width / 2) entered a wall
+    float distance = 0.0f;     // path length in px
+    float backingTime = 0.0f;  // seconds spent reversing
+};
+
+// Every combination of the listed values, each from every start pose
+std::vector<SweepRun> MakeSweepGrid(const std::vector<float>& minSpeeds,
+                                   const std::vector<float>& maxSpeeds,
+                                   const std::vector<float>& minObsDists,
+                                   const std::vector<float>& backupTimes,
+                                   const std::vector<Vector2>& starts,
+                                   const std::vector<float>& startHeadings);
+
+// Simulate one run for the given time on a fixed step and fill its metrics
+void SimulateRun(SweepRun& run, const DistanceField& field, float seconds, float dt, float width = 40.0f);
+
+// Simulate all runs, spread across the pool
+void RunSweep(std::vector<SweepRun>& runs, const DistanceField& field, float seconds, float dt, ThreadPool& pool);
+
+bool WriteSweepCsv(const char* filename, const std::vector<SweepRun>& runs);
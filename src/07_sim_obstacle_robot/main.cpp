@@ -1,89 +1,61 @@
 #include "raylib.h"
+#include <chrono>
 #include <cmath>
 #include <vector>
 #include <limits>
+#include <random>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <thread>
+#include <algorithm>
+#include "DistanceField.h"
+#include "Robot.h"
+#include "Fleet.h"
+#include "ThreadPool.h"
+#include "FixedTimestep.h"
+#include "Sweep.h"
+#include "Planner.h"
 
-// ---------- Helpers ----------
-float ClampFloat(float value, float minVal, float maxVal) {
-    if (value < minVal) return minVal;
-    if (value > maxVal) return maxVal;
-    return value;
-}
-
-float LerpFloat(float a, float b, float t) {
-    return a + t * (b - a);
-}
-
-float Vector2Dist(Vector2 a, Vector2 b) {
-    float dx = a.x - b.x;
-    float dy = a.y - b.y;
-    return sqrtf(dx * dx + dy * dy);
-}
-
-// ---------------- ROBOT ----------------
-struct Robot {
-    Vector2 pos;
-    float heading;
-    float width;
-
-    float vl, vr;
-    float minSpeed, maxSpeed;
-
-    float minObsDist;
-    float countDown;
-
-    Robot(Vector2 start, float w) {
-        pos = start;
-        heading = 0.0f;
-        width = w;
-
-        minSpeed = 40.0f;
-        maxSpeed = 80.0f;
-        vl = vr = minSpeed;
+// ---------------- SENSOR ----------------
+struct SensorRay {
+    Vector2 start;
+    Vector2 end;
+    bool hitObstacle;
+};
 
-        minObsDist = 100.0f;
-        countDown = 5.0f;
-    }
+// Sphere-trace each ray through the precomputed distance field
+std::vector<SensorRay> SenseObstacles(const Robot& robot, const DistanceField& field, float range, float fov) {
+    std::vector<SensorRay> rays;
 
-    void MoveForward() { vl = vr = minSpeed; }
-    void MoveBackward() { vr = -minSpeed; vl = -minSpeed * 0.5f; }
+    float startAngle = robot.heading - fov;
+    float endAngle = robot.heading + fov;
+    int rayCount = 10;
 
-    void Kinematics(float dt) {
-        float v = (vl + vr) * 0.5f;
-        pos.x += v * cosf(heading) * dt;
-        pos.y -= v * sinf(heading) * dt;
-        heading += (vr - vl) / width * dt;
-        heading = fmodf(heading, 2 * PI);
+    for (int r = 0; r < rayCount; r++) {
+        float angle = LerpFloat(startAngle, endAngle, r / (float)rayCount);
 
-        vl = ClampFloat(vl, -maxSpeed, maxSpeed);
-        vr = ClampFloat(vr, -maxSpeed, maxSpeed);
-    }
+        SensorRay ray;
+        ray.start = robot.pos;
+        ray.end = { robot.pos.x + range * cosf(angle),
+                    robot.pos.y - range * sinf(angle) };
+        ray.hitObstacle = false;
 
-    void AvoidObstacles(const std::vector<Vector2>& points, float dt) {
-        float closest = std::numeric_limits<float>::max();
-        for (auto& p : points) {
-            float d = Vector2Dist(pos, p);
-            if (d < closest) closest = d;
+        float hit;
+        if (field.CastRay(robot.pos, angle, range, hit)) {
+            ray.end = { robot.pos.x + hit * cosf(angle),
+                        robot.pos.y - hit * sinf(angle) };
+            ray.hitObstacle = true;
         }
 
-        if (closest < minObsDist && countDown > 0) {
-            countDown -= dt;
-            MoveBackward();
-        } else {
-            countDown = 5.0f;
-            MoveForward();
-        }
+        rays.push_back(ray);
     }
-};
 
-// ---------------- SENSOR ----------------
-struct SensorRay {
-    Vector2 start;
-    Vector2 end;
-    bool hitObstacle;
-};
+    return rays;
+}
 
-std::vector<SensorRay> SenseObstacles(const Robot& robot, Image& mapImg, Color* pixels, float range, float fov) {
+// Original pixel-step sampler, kept for comparison in --bench
+std::vector<SensorRay> SenseObstaclesFixedStep(const Robot& robot, Image& mapImg, Color* pixels, float range, float fov) {
     std::vector<SensorRay> rays;
     int w = mapImg.width;
     int h = mapImg.height;
@@ -123,8 +95,375 @@ std::vector<SensorRay> SenseObstacles(const Robot& robot, Image& mapImg, Color*
     return rays;
 }
 
+// One simulation step: sense, avoid, move. rays keeps the last scan for
+// drawing. With a target (the next corner of a planned path) the robot
+// steers for it instead; the plan already keeps it clear of the walls.
+void StepRobot(Robot& robot, const DistanceField& field, float dt, std::vector<SensorRay>& rays,
+               const Vector2* target = nullptr) {
+    rays = SenseObstacles(robot, field, 250.0f, DEG2RAD * 40);
+
+    if (target) {
+        robot.SeekTarget(*target);
+    } else {
+        // Extract obstacle points for avoidance
+        std::vector<Vector2> points;
+        for (auto& r : rays)
+            if (r.hitObstacle) points.push_back(r.end);
+        robot.AvoidObstacles(points, dt);
+    }
+    robot.Kinematics(dt);
+}
+
+// Walls are inflated by half the robot's body plus a small margin
+const float PLAN_RADIUS = 28.0f;
+
+// Interpolate headings the short way round
+float LerpAngle(float a, float b, float t) {
+    float d = remainderf(b - a, 2 * PI);
+    return a + d * t;
+}
+
+// ---------------- BENCHMARK ----------------
+// Wall-clock seconds since start. The headless modes never open a window,
+// and raylib's GetTime() reads 0 until one is open.
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Rays per second over random free poses: pixel stepping vs distance field
+int RunBenchmark(const char* mapFile) {
+    Image mapImg = LoadImage(mapFile);
+    if (mapImg.data == nullptr) {
+        printf("could not load %s\n", mapFile);
+        return 1;
+    }
+    Color* pixels = LoadImageColors(mapImg);
+
+    auto start = std::chrono::steady_clock::now();
+    DistanceField field(mapImg);
+    double buildMs = SecondsSince(start) * 1000.0;
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> rx(0, mapImg.width), ry(0, mapImg.height), rh(0, 2 * PI);
+    std::vector<Robot> robots;
+    while (robots.size() < 20000) {
+        Robot r({rx(gen), ry(gen)}, 40.0f);
+        r.heading = rh(gen);
+        if (!field.IsWall((int)r.pos.x, (int)r.pos.y)) robots.push_back(r);
+    }
+
+    const float range = 250.0f, fov = DEG2RAD * 40;
+    start = std::chrono::steady_clock::now();
+    size_t fixedHits = 0;
+    for (auto& r : robots)
+        for (auto& ray : SenseObstaclesFixedStep(r, mapImg, pixels, range, fov)) fixedHits += ray.hitObstacle;
+    double fixedRate = robots.size() * 10.0 / SecondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    size_t fieldHits = 0;
+    for (auto& r : robots)
+        for (auto& ray : SenseObstacles(r, field, range, fov)) fieldHits += ray.hitObstacle;
+    double fieldRate = robots.size() * 10.0 / SecondsSince(start);
+
+    printf("%s: distance field built in %.1f ms\n", mapFile, buildMs);
+    printf("pixel steps:    %10.0f rays/s  (%zu hits)\n", fixedRate, fixedHits);
+    printf("distance field: %10.0f rays/s  (%zu hits)  %.1fx\n", fieldRate, fieldHits, fieldRate / fixedRate);
+
+    UnloadImageColors(pixels);
+    UnloadImage(mapImg);
+    return 0;
+}
+
+// Headless fleet: robot-steps per second on a fixed 1/60 s timestep for
+// 1..N threads. Every thread count replays the same fleet from the same
+// spawn, so the final poses must match the single-threaded run exactly.
+int RunFleet(const char* mapFile, int count, int steps, int maxThreads) {
+    Image mapImg = LoadImage(mapFile);
+    if (mapImg.data == nullptr) {
+        printf("could not load %s\n", mapFile);
+        return 1;
+    }
+    DistanceField field(mapImg);
+    UnloadImage(mapImg);
+
+    std::vector<int> threadCounts;
+    for (int t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    printf("%s: %d robots x %d steps (dt = 1/60 s)\n", mapFile, count, steps);
+    const float dt = 1.0f / 60.0f;
+
+    // Reference: the interactive path (Robot objects, per-step vectors)
+    {
+        Fleet spawn;
+        spawn.Spawn(count, field, 42);
+        std::vector<Robot> robots;
+        for (int i = 0; i < count; i++) {
+            robots.emplace_back(Vector2{spawn.x[i], spawn.y[i]}, 40.0f);
+            robots.back().heading = spawn.heading[i];
+        }
+        int refSteps = steps < 60 ? steps : 60;
+        auto start = std::chrono::steady_clock::now();
+        for (int s = 0; s < refSteps; s++) {
+            for (auto& robot : robots) {
+                auto rays = SenseObstacles(robot, field, 250.0f, DEG2RAD * 40);
+                std::vector<Vector2> points;
+                for (auto& r : rays)
+                    if (r.hitObstacle) points.push_back(r.end);
+                robot.AvoidObstacles(points, dt);
+                robot.Kinematics(dt);
+            }
+        }
+        printf("Robot objects, 1 thread: %.0f robot-steps/s\n", (double)count * refSteps / SecondsSince(start));
+    }
+
+    printf("threads  robot-steps/s  speedup  matches 1 thread\n");
+    std::vector<float> reference;
+    double baseRate = 0.0;
+    for (int t : threadCounts) {
+        ThreadPool pool(t);
+        Fleet fleet;
+        fleet.Spawn(count, field, 42);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int s = 0; s < steps; s++) fleet.Step(dt, field, &pool);
+        double rate = (double)count * steps / SecondsSince(start);
+        if (t == 1) { baseRate = rate; reference = fleet.x; }
+
+        printf("%7d  %13.0f  %6.2fx  %s\n", t, rate, rate / baseRate, fleet.x == reference ? "yes" : "NO");
+    }
+    return 0;
+}
+
+// Batch mode: the same 240 Hz simulation driven by different frame
+// schedules must end in exactly the same state; stepping by the raw
+// frame time (the old loop) does not. Then runs flat out with no frames.
+int RunBatch(const char* mapFile, float seconds, double hz) {
+    Image mapImg = LoadImage(mapFile);
+    if (mapImg.data == nullptr) {
+        printf("could not load %s\n", mapFile);
+        return 1;
+    }
+    DistanceField field(mapImg);
+    UnloadImage(mapImg);
+
+    const long totalSteps = (long)(seconds * hz);
+    std::vector<SensorRay> rays;
+    printf("%s: %.0f s simulated, fixed step %.0f Hz (%ld steps)\n", mapFile, seconds, hz, totalSteps);
+    printf("frames                 fixed-step final pose          frame-dt final pose    frame-dt in walls\n");
+
+    struct Schedule { const char* name; float frame; bool jitter; };
+    Schedule schedules[] = { {"30 FPS", 1 / 30.0f, false}, {"60 FPS", 1 / 60.0f, false},
+                             {"144 FPS", 1 / 144.0f, false}, {"jittery 1-200 ms", 0.0f, true} };
+    Robot reference({200, 200}, 40.0f);
+    bool deterministic = true;
+    for (int k = 0; k < 4; k++) {
+        const Schedule& sc = schedules[k];
+        std::mt19937 gen(7);
+        std::uniform_real_distribution<float> jitter(0.001f, 0.2f);
+
+        // Fixed step: feed frames into the accumulator until totalSteps ran
+        Robot fixed({200, 200}, 40.0f);
+        FixedTimestep clock(hz);
+        long done = 0;
+        while (done < totalSteps) {
+            int steps = clock.Advance(sc.jitter ? jitter(gen) : sc.frame);
+            for (int s = 0; s < steps && done < totalSteps; s++, done++)
+                StepRobot(fixed, field, (float)clock.Dt(), rays);
+        }
+
+        // Old loop: one step per frame with the frame time
+        gen.seed(7);
+        Robot variable({200, 200}, 40.0f);
+        int inWalls = 0;
+        for (double t = 0.0; t < seconds; ) {
+            float frame = sc.jitter ? jitter(gen) : sc.frame;
+            StepRobot(variable, field, frame, rays);
+            inWalls += field.IsWall((int)variable.pos.x, (int)variable.pos.y);
+            t += frame;
+        }
+
+        if (k == 0) reference = fixed;
+        bool same = fixed.pos.x == reference.pos.x && fixed.pos.y == reference.pos.y &&
+                    fixed.heading == reference.heading;
+        deterministic = deterministic && same;
+        printf("%-17s  (%7.2f, %7.2f, %6.3f) %s  (%7.2f, %7.2f, %6.3f)  %5d frames\n", sc.name,
+               fixed.pos.x, fixed.pos.y, fixed.heading, same ? "==" : "!=",
+               variable.pos.x, variable.pos.y, variable.heading, inWalls);
+    }
+
+    // Flat out: no frames at all
+    Robot robot({200, 200}, 40.0f);
+    auto start = std::chrono::steady_clock::now();
+    for (long s = 0; s < totalSteps; s++) StepRobot(robot, field, (float)(1.0 / hz), rays);
+    double wall = SecondsSince(start);
+    printf("batch: %.0f simulated s in %.3f s wall = %.0fx real time\n", seconds, wall, seconds / wall);
+    printf("%s\n", deterministic ? "fixed step is deterministic across frame rates" : "FIXED STEP DIVERGED");
+    return deterministic ? 0 : 1;
+}
+
+// Parameter sweep: every grid point from several start poses, run
+// headless on the thread pool; results go to a CSV file
+int RunParameterSweep(const char* mapFile, float seconds, int threads, const char* csvFile) {
+    Image mapImg = LoadImage(mapFile);
+    if (mapImg.data == nullptr) {
+        printf("could not load %s\n", mapFile);
+        return 1;
+    }
+    DistanceField field(mapImg);
+    UnloadImage(mapImg);
+
+    // Start poses spread over free space, the same for every grid point
+    Fleet starts;
+    starts.Spawn(4, field, 11);
+    std::vector<Vector2> startPos;
+    std::vector<float> startHeading;
+    for (int i = 0; i < starts.Size(); i++) {
+        startPos.push_back({starts.x[i], starts.y[i]});
+        startHeading.push_back(starts.heading[i]);
+    }
+    startPos.push_back({200, 200});   // the interactive start
+    startHeading.push_back(0.0f);
+
+    std::vector<SweepRun> runs = MakeSweepGrid(
+        {20, 30, 40, 50, 60, 80},            // minSpeed
+        {80},                                // maxSpeed (only clamps; above every minSpeed)
+        {40, 60, 80, 100, 120, 150},         // minObsDist
+        {0.5f, 1, 2, 5},                     // backupTime
+        startPos, startHeading);
+
+    const float dt = 1.0f / 240.0f;
+    ThreadPool pool(threads);
+    auto start = std::chrono::steady_clock::now();
+    RunSweep(runs, field, seconds, dt, pool);
+    double wall = SecondsSince(start);
+
+    if (!WriteSweepCsv(csvFile, runs)) {
+        printf("could not write %s\n", csvFile);
+        return 1;
+    }
+
+    printf("%s: %zu runs x %.0f s at 240 Hz on %d thread(s)\n", mapFile, runs.size(), seconds, pool.Size());
+    printf("%.2f s wall, %.0f simulated s per wall s, results in %s\n",
+           wall, runs.size() * seconds / wall, csvFile);
+
+    // Quick summary: collision-free settings that covered the most ground
+    struct Summary { RobotParams p; int collisions = 0; float distance = 0, backing = 0; };
+    std::vector<Summary> perParams;
+    for (size_t i = 0; i < runs.size(); i += startPos.size()) {
+        Summary s;
+        s.p = runs[i].params;
+        for (size_t k = i; k < i + startPos.size(); k++) {
+            s.collisions += runs[k].collisions;
+            s.distance += runs[k].distance / startPos.size();
+            s.backing += runs[k].backingTime / startPos.size();
+        }
+        perParams.push_back(s);
+    }
+    std::sort(perParams.begin(), perParams.end(), [](const Summary& a, const Summary& b) {
+        if ((a.collisions == 0) != (b.collisions == 0)) return a.collisions == 0;
+        return a.distance > b.distance;
+    });
+    printf("minSpeed  minObsDist  backupTime  collisions  mean distance  mean backing s\n");
+    for (size_t i = 0; i < perParams.size() && i < 5; i++) {
+        const Summary& s = perParams[i];
+        printf("%8.0f  %10.0f  %10.1f  %10d  %13.0f  %14.1f\n", s.p.minSpeed, s.p.minObsDist,
+               s.p.backupTime, s.collisions, s.distance, s.backing);
+    }
+    return 0;
+}
+
+// Planner latency over random free start / goal pairs on the real map:
+// plain A*, jump point search, and the coarse-to-fine hierarchical search.
+// JPS must find paths exactly as short as A*.
+int RunPlannerBenchmark(const char* mapFile, int queries) {
+    Image mapImg = LoadImage(mapFile);
+    if (mapImg.data == nullptr) {
+        printf("could not load %s\n", mapFile);
+        return 1;
+    }
+    DistanceField field(mapImg);
+    UnloadImage(mapImg);
+
+    GridPlanner planner;
+    auto start = std::chrono::steady_clock::now();
+    planner.Build(field, PLAN_RADIUS);
+    printf("%s: inflated grid (radius %.0f px) built in %.2f ms, %.1f MB of search state\n", mapFile,
+           PLAN_RADIUS, SecondsSince(start) * 1000.0, planner.MemoryBytes() / (1024.0 * 1024.0));
+
+    std::mt19937 gen(5);
+    std::uniform_real_distribution<float> rx(0, (float)planner.Width()), ry(0, (float)planner.Height());
+    auto randomFree = [&]() {
+        Vector2 p;
+        do { p = { rx(gen), ry(gen) }; } while (planner.Blocked((int)p.x, (int)p.y));
+        return p;
+    };
+    std::vector<Vector2> from, to;
+    for (int i = 0; i < queries; i++) { from.push_back(randomFree()); to.push_back(randomFree()); }
+
+    struct Method { const char* name; bool (GridPlanner::*fn)(Vector2, Vector2, std::vector<Vector2>&, PlanStats*); };
+    Method methods[] = { {"A*", &GridPlanner::FindPathAStar}, {"JPS", &GridPlanner::FindPath},
+                         {"hierarchical", &GridPlanner::FindPathHierarchical}, {"Plan()", &GridPlanner::Plan} };
+
+    std::vector<float> reference(queries, 0.0f);
+    std::vector<Vector2> path;
+    bool optimal = true;
+    printf("method         mean us  median us    max us  expanded  found  cost vs A*\n");
+    for (const Method& m : methods) {
+        std::vector<double> micros;
+        double expanded = 0.0, costRatio = 0.0;
+        int found = 0;
+        for (int i = 0; i < queries; i++) {
+            PlanStats stats;
+            if (!(planner.*m.fn)(from[i], to[i], path, &stats)) { micros.push_back(stats.micros); continue; }
+            micros.push_back(stats.micros);
+            expanded += stats.expanded;
+            found++;
+            if (m.fn == &GridPlanner::FindPathAStar) reference[i] = stats.cost;
+            costRatio += reference[i] > 0.0f ? stats.cost / reference[i] : 1.0;
+            if (m.fn == &GridPlanner::FindPath && fabsf(stats.cost - reference[i]) > 1e-2f * reference[i]) optimal = false;
+        }
+        std::vector<double> sorted = micros;
+        std::sort(sorted.begin(), sorted.end());
+        double mean = 0.0;
+        for (double us : micros) mean += us;
+        mean /= queries;
+        printf("%-12s  %8.1f  %9.1f  %8.1f  %8.0f  %5d  %10.4f\n", m.name, mean, sorted[queries / 2],
+               sorted.back(), found ? expanded / found : 0.0, found, found ? costRatio / found : 0.0);
+    }
+    printf("%s\n", optimal ? "JPS path costs match A*" : "JPS PATH COSTS DIFFER FROM A*");
+    return optimal ? 0 : 1;
+}
+
 // ---------------- MAIN ----------------
-int main() {
+int main(int argc, char** argv) {
+    if (argc > 1 && strcmp(argv[1], "--fleet") == 0) {
+        int count = argc > 2 ? atoi(argv[2]) : 10000;
+        int steps = argc > 3 ? atoi(argv[3]) : 600;
+        int threads = argc > 4 ? atoi(argv[4]) : (int)std::thread::hardware_concurrency();
+        return RunFleet("assets/background.png", count, steps, threads > 0 ? threads : 1);
+    }
+    if (argc > 1 && strcmp(argv[1], "--sweep") == 0) {
+        float seconds = argc > 2 ? (float)atof(argv[2]) : 120.0f;
+        int threads = argc > 3 ? atoi(argv[3]) : (int)std::thread::hardware_concurrency();
+        const char* csv = argc > 4 ? argv[4] : "sweep.csv";
+        return RunParameterSweep("assets/background.png", seconds, threads > 0 ? threads : 1, csv);
+    }
+    if (argc > 1 && strcmp(argv[1], "--batch") == 0) {
+        float seconds = argc > 2 ? (float)atof(argv[2]) : 600.0f;
+        double hz = argc > 3 ? atof(argv[3]) : 240.0;
+        return RunBatch("assets/background.png", seconds, hz);
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-plan") == 0) {
+        int queries = argc > 2 ? atoi(argv[2]) : 1000;
+        return RunPlannerBenchmark("assets/background.png", queries > 0 ? queries : 1);
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        if (argc > 2) return RunBenchmark(argv[2]);
+        RunBenchmark("assets/background.png");
+        return RunBenchmark("assets/floor_plan.png");
+    }
+
     const int SCREEN_W = 1200;
     const int SCREEN_H = 600;
 
@@ -141,22 +480,47 @@ int main() {
     }
 
     Image mapImg = LoadImageFromTexture(mapTex);
-    Color* pixels = LoadImageColors(mapImg);
+    DistanceField field(mapImg);   // built once, read by every sensor ray
+    GridPlanner planner;
+    planner.Build(field, PLAN_RADIUS);
+
+    // Right click sets a goal; the path is replanned from the robot's
+    // current cell on every control tick until the goal is reached
+    bool hasGoal = false;
+    Vector2 goal = {0, 0};
+    std::vector<Vector2> path;
+    PlanStats planStats;
 
     Robot robot({200, 200}, 40.0f);
+    Robot previous = robot;          // pose before the last step, for interpolation
+    std::vector<SensorRay> rays = SenseObstacles(robot, field, 250.0f, DEG2RAD * 40);
+
+    // Physics and sensing run at 240 Hz whatever the frame rate
+    FixedTimestep clock(240.0);
 
     while (!WindowShouldClose()) {
-        float dt = GetFrameTime();
+        if (IsMouseButtonPressed(MOUSE_BUTTON_RIGHT)) {
+            goal = GetMousePosition();
+            hasGoal = planner.NearestFree(goal, goal);
+        }
 
-        auto rays = SenseObstacles(robot, mapImg, pixels, 250.0f, DEG2RAD * 40);
+        int steps = clock.Advance(GetFrameTime());
+        for (int s = 0; s < steps; s++) {
+            previous = robot;
+            if (hasGoal && Vector2Dist(robot.pos, goal) < 6.0f) hasGoal = false;
+            if (hasGoal && !planner.Plan(robot.pos, goal, path, &planStats)) hasGoal = false;
+            if (!hasGoal) path.clear();
 
-        // Extract obstacle points for avoidance
-        std::vector<Vector2> points;
-        for (auto& r : rays)
-            if (r.hitObstacle) points.push_back(r.end);
+            // path[0] is the robot's own cell; steer for the next corner
+            const Vector2* target = path.size() > 1 ? &path[1] : nullptr;
+            StepRobot(robot, field, (float)clock.Dt(), rays, target);
+        }
 
-        robot.AvoidObstacles(points, dt);
-        robot.Kinematics(dt);
+        // Draw the robot between its last two simulated poses
+        float alpha = clock.Alpha();
+        Vector2 drawPos = { LerpFloat(previous.pos.x, robot.pos.x, alpha),
+                            LerpFloat(previous.pos.y, robot.pos.y, alpha) };
+        float drawHeading = LerpAngle(previous.heading, robot.heading, alpha);
 
         BeginDrawing();
         ClearBackground(WHITE);
@@ -169,19 +533,28 @@ int main() {
             if (r.hitObstacle) DrawCircleV(r.end, 3, RED);       // red obstacle points
         }
 
+        // Planned path
+        for (size_t i = 1; i < path.size(); i++) DrawLineEx(path[i - 1], path[i], 2.0f, DARKGREEN);
+        if (hasGoal) DrawCircleLinesV(goal, 8, DARKGREEN);
+
         DrawTexturePro(
             botTex,
             {0, 0, (float)botTex.width, (float)botTex.height},
-            {robot.pos.x, robot.pos.y, (float)botTex.width, (float)botTex.height},
+            {drawPos.x, drawPos.y, (float)botTex.width, (float)botTex.height},
             {botTex.width / 2.0f, botTex.height / 2.0f},
-            -RAD2DEG * robot.heading,
+            -RAD2DEG * drawHeading,
             WHITE
         );
 
+        if (hasGoal)
+            DrawText(TextFormat("plan %s %.0f us  %d expanded  %.0f px", planStats.hierarchical ? "coarse+JPS" : "JPS",
+                                planStats.micros, planStats.expanded, planStats.cost), 10, 10, 20, DARKGRAY);
+        else
+            DrawText("right click to set a goal", 10, 10, 20, DARKGRAY);
+
         EndDrawing();
     }
 
-    UnloadImageColors(pixels);
     UnloadImage(mapImg);
     UnloadTexture(mapTex);
     UnloadTexture(botTex);
@@ -0,0 +1,60 @@
+#include "FollowerBatch.h"
+#include "LineField.h"
+#include "PathIndex.h"
+#include "ThreadPool.h"
+#include <cmath>
+
+void FollowerBatch::Spawn(const std::vector<Gains>& gains, const std::vector<Vector2>& starts,
+                          const std::vector<float>& headings, const PathIndex& path) {
+    int n = (int)gains.size();
+    x.resize(n); y.resize(n); angle.resize(n);
+    integral.assign(n, 0.0f); lastError.assign(n, 0.0f);
+    kp.resize(n); ki.resize(n); kd.resize(n);
+    progress.assign(n, 0.0f); lastArc.resize(n); hint.resize(n);
+    offsetSum.assign(n, 0.0); steps.assign(n, 0); lapFrame.assign(n, -1);
+    lost.assign(n, 0);
+
+    for (int i = 0; i < n; i++) {
+        x[i] = starts[i].x; y[i] = starts[i].y; angle[i] = headings[i];
+        kp[i] = gains[i].kp; ki[i] = gains[i].ki; kd[i] = gains[i].kd;
+        PathHit hit = path.Closest(starts[i]);
+        lastArc[i] = hit.arcLength;
+        hint[i] = hit.segment;
+    }
+}
+
+void FollowerBatch::StepRange(int begin, int end, int frame, const LineField& field, const PathIndex& path) {
+    const float length = path.Length();
+    for (int i = begin; i < end; i++) {
+        if (lost[i]) continue;
+
+        // PID on the lateral error, then move (same order as StepRobot)
+        float error = field.LateralError({x[i], y[i]}, angle[i], config.scanWidth, config.lookAhead);
+        integral[i] += error;
+        float derivative = steps[i] > 0 ? error - lastError[i] : 0.0f;
+        lastError[i] = error;
+        angle[i] += kp[i] * error + ki[i] * integral[i] + kd[i] * derivative;
+        x[i] += cosf(angle[i]) * config.speed;
+        y[i] += sinf(angle[i]) * config.speed;
+
+        // Score against the analytic path
+        PathHit hit = path.Closest({x[i], y[i]}, hint[i]);
+        hint[i] = hit.segment;
+        float delta = hit.arcLength - lastArc[i];
+        if (delta < -0.5f * length) delta += length;   // crossed the start line forwards
+        else if (delta > 0.5f * length) delta -= length;
+        lastArc[i] = hit.arcLength;
+        progress[i] += delta;
+        offsetSum[i] += hit.distance;
+        steps[i]++;
+
+        if (lapFrame[i] < 0 && progress[i] >= length) lapFrame[i] = frame + 1;
+        if (hit.distance > config.lostDistance) lost[i] = 1;
+    }
+}
+
+void FollowerBatch::Step(int frame, const LineField& field, const PathIndex& path, ThreadPool* pool) {
+    auto work = [&](int begin, int end, int) { StepRange(begin, end, frame, field, path); };
+    if (pool) pool->ParallelFor(Size(), work);
+    else work(0, Size(), 0);
+}
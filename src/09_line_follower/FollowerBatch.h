@@ -0,0 +1,58 @@
+#pragma once
+#include "raylib.h"
+#include <vector>
+
+class LineField;
+class PathIndex;
+class ThreadPool;
+
+// Steering gains; a P controller has ki = kd = 0. Terms are per frame,
+// like the interactive robot's Kp.
+struct Gains {
+    float kp = 0.06f;
+    float ki = 0.0f;
+    float kd = 0.0f;
+};
+
+// Sensor and motion settings shared by every robot of a batch
+struct BatchConfig {
+    float speed = 2.0f;        // pixels per frame
+    float scanWidth = 28.0f;
+    float lookAhead = 15.0f;
+    float lostDistance = 40.0f; // a robot this far from the path is out
+};
+
+// Many line followers in structure-of-arrays form, each with its own gains
+// and start pose, stepped headless on the same read-only line field and
+// path index. Robots never interact, so each step splits across a pool.
+// Scoring runs alongside: progress along the path (unwrapped arc length),
+// first-lap time and mean |lateral offset|.
+class FollowerBatch {
+public:
+    BatchConfig config;
+
+    // State
+    std::vector<float> x, y, angle;
+    std::vector<float> integral, lastError;
+    std::vector<float> kp, ki, kd;
+    // Scoring
+    std::vector<float> progress, lastArc;
+    std::vector<int> hint;
+    std::vector<double> offsetSum;
+    std::vector<int> steps, lapFrame;   // lapFrame is -1 until the first lap is done
+    std::vector<unsigned char> lost;
+
+    int Size() const { return (int)x.size(); }
+
+    // One robot per entry of gains, starting at the matching pose
+    void Spawn(const std::vector<Gains>& gains, const std::vector<Vector2>& starts,
+               const std::vector<float>& headings, const PathIndex& path);
+
+    // Advance every robot by one frame; pool may be null
+    void Step(int frame, const LineField& field, const PathIndex& path, ThreadPool* pool = nullptr);
+
+    float MeanOffset(int i) const { return steps[i] > 0 ? (float)(offsetSum[i] / steps[i]) : 0.0f; }
+
+private:
+    void StepRange(int begin, int end, int frame, const LineField& field, const PathIndex& path);
+};
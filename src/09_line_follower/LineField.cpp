@@ -0,0 +1,111 @@
+#include "LineField.h"
+#include <cmath>
+#include <limits>
+
+// 1D squared distance transform of f (length n) into d: the lower
+// envelope of parabolas rooted at each sample (Felzenszwalb & Huttenlocher).
+// v and z are scratch buffers of size n and n + 1.
+static void DistanceTransform1D(const float* f, float* d, int n, int* v, float* z) {
+    const float INF = std::numeric_limits<float>::infinity();
+    int k = 0;
+    v[0] = 0;
+    z[0] = -INF;
+    z[1] = INF;
+    for (int q = 1; q < n; q++) {
+        float s = ((f[q] + (float)q * q) - (f[v[k]] + (float)v[k] * v[k])) / (2.0f * (q - v[k]));
+        while (s <= z[k]) {
+            k--;
+            s = ((f[q] + (float)q * q) - (f[v[k]] + (float)v[k] * v[k])) / (2.0f * (q - v[k]));
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = INF;
+    }
+    k = 0;
+    for (int q = 0; q < n; q++) {
+        while (z[k + 1] < q) k++;
+        float dq = (float)(q - v[k]);
+        d[q] = dq * dq + f[v[k]];
+    }
+}
+
+// Euclidean distance from every pixel centre to the nearest seed pixel
+// centre (seeds are 0 in dist, everything else starts at FAR)
+static void DistanceTransform2D(std::vector<float>& dist, int width, int height) {
+    int n = (width > height) ? width : height;
+    std::vector<float> f(n), d(n), z(n + 1);
+    std::vector<int> v(n);
+
+    // Columns, then rows
+    for (int x = 0; x < width; x++) {
+        for (int y = 0; y < height; y++) f[y] = dist[y * width + x];
+        DistanceTransform1D(f.data(), d.data(), height, v.data(), z.data());
+        for (int y = 0; y < height; y++) dist[y * width + x] = d[y];
+    }
+    for (int y = 0; y < height; y++) {
+        float* row = &dist[y * width];
+        DistanceTransform1D(row, d.data(), width, v.data(), z.data());
+        for (int x = 0; x < width; x++) row[x] = sqrtf(d[x]);
+    }
+}
+
+LineField::LineField(const Image& lineImage) : width(lineImage.width), height(lineImage.height) {
+    wordsPerRow = (width + 63) / 64;
+    mask.assign((size_t)wordsPerRow * height, 0);
+
+    // Large but finite "no seed" value keeps the parabola maths NaN-free
+    const float FAR = 1e12f;
+    std::vector<float> outside((size_t)width * height, FAR);
+    std::vector<float> inside((size_t)width * height, FAR);
+
+    Color* pixels = LoadImageColors(lineImage);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            Color c = pixels[y * width + x];
+            if (c.r < 50 && c.g < 50 && c.b < 50) {
+                mask[y * wordsPerRow + (x >> 6)] |= 1ull << (x & 63);
+                outside[y * width + x] = 0.0f;
+            } else {
+                inside[y * width + x] = 0.0f;
+            }
+        }
+    }
+    UnloadImageColors(pixels);
+
+    DistanceTransform2D(outside, width, height);
+    DistanceTransform2D(inside, width, height);
+
+    // The edge sits half a pixel from the centres on either side of it
+    sdf.resize((size_t)width * height);
+    for (size_t i = 0; i < sdf.size(); i++)
+        sdf[i] = (outside[i] > 0.0f) ? outside[i] - 0.5f : 0.5f - inside[i];
+}
+
+float LineField::At(int x, int y) const {
+    // Clamp to the border: the field just continues past the image edge
+    if (x < 0) x = 0; else if (x >= width) x = width - 1;
+    if (y < 0) y = 0; else if (y >= height) y = height - 1;
+    return sdf[y * width + x];
+}
+
+float LineField::Distance(Vector2 p) const {
+    float fx = p.x - 0.5f, fy = p.y - 0.5f;
+    int x = (int)floorf(fx), y = (int)floorf(fy);
+    float tx = fx - x, ty = fy - y;
+    float top = At(x, y) + (At(x + 1, y) - At(x, y)) * tx;
+    float bottom = At(x, y + 1) + (At(x + 1, y + 1) - At(x, y + 1)) * tx;
+    return top + (bottom - top) * ty;
+}
+
+float LineField::LateralError(Vector2 pos, float heading, float scanWidth, float lookAhead) const {
+    float fx = cosf(heading), fy = sinf(heading);
+    Vector2 sensor = { pos.x + fx * lookAhead, pos.y + fy * lookAhead };
+    float h = scanWidth * 0.5f;
+    if (Distance(sensor) > h) return 0.0f;
+
+    // Right of heading is (-fy, fx) with y pointing down
+    float left = Distance({ sensor.x + fy * h, sensor.y - fx * h });
+    float right = Distance({ sensor.x - fy * h, sensor.y + fx * h });
+    return (left - right) * 0.5f;
+}
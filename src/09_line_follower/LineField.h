@@ -0,0 +1,45 @@
+#pragma once
+#include "raylib.h"
+#include <cstdint>
+#include <vector>
+
+// The rasterised path baked once at startup: a 1-bit mask for on-line
+// tests and a signed distance field (negative inside the line) for
+// sub-pixel lateral error. Both replace per-query GetImageColor reads.
+class LineField {
+public:
+    LineField() = default;
+    // Dark pixels (all channels < 50) are the line
+    explicit LineField(const Image& lineImage);
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+
+    bool OnLine(Vector2 p) const {
+        if (p.x < 0 || p.y < 0 || p.x >= width || p.y >= height) return false;
+        int x = (int)p.x, y = (int)p.y;
+        return (mask[y * wordsPerRow + (x >> 6)] >> (x & 63)) & 1;
+    }
+
+    // Signed distance to the line's edge in pixels, bilinear between pixel
+    // centres: negative inside the line, positive outside
+    float Distance(Vector2 p) const;
+
+    // Lateral offset of the line's centre under a sensor bar scanWidth wide,
+    // lookAhead in front of pos, positive to the right of heading. Across
+    // a line of half-width w centred e to the right the field reads
+    // |x - e| - w, so the bar's ends (half-length h) read h + e - w and
+    // h - e - w: half their difference is e, whatever the line's width.
+    // Saturates at +-h past the bar's ends; 0 if no line is under the bar.
+    float LateralError(Vector2 pos, float heading, float scanWidth, float lookAhead) const;
+
+    size_t MemoryBytes() const { return mask.size() * sizeof(uint64_t) + sdf.size() * sizeof(float); }
+
+private:
+    int width = 0, height = 0;
+    int wordsPerRow = 0;
+    std::vector<uint64_t> mask;
+    std::vector<float> sdf;
+
+    float At(int x, int y) const;
+};
@@ -0,0 +1,161 @@
+#include "LineRaster.h"
+#include <cmath>
+#include <cstdint>
+
+static const int TILE_SHIFT = 5;
+static const int TILE = 1 << TILE_SHIFT;   // 32 pixels: one uint32 of coverage per tile row
+
+// One polyline segment prepared for span queries
+struct SpanSegment {
+    float ax, ay;       // start point; its disc is the round join / cap
+    float bx, by;       // end point
+    float ux, uy, len;  // unit direction and length
+    float invUx, invUy; // 0 when the component is 0
+    bool lastDisc;      // the final segment also needs the disc at its end
+};
+
+static SpanSegment PrepareSegment(Vector2 a, Vector2 b, bool last) {
+    SpanSegment s;
+    s.ax = a.x; s.ay = a.y;
+    s.bx = b.x; s.by = b.y;
+    float dx = b.x - a.x, dy = b.y - a.y;
+    s.len = sqrtf(dx * dx + dy * dy);
+    s.ux = s.len > 0.0f ? dx / s.len : 0.0f;
+    s.uy = s.len > 0.0f ? dy / s.len : 0.0f;
+    s.invUx = fabsf(s.ux) > 1e-6f ? 1.0f / s.ux : 0.0f;
+    s.invUy = fabsf(s.uy) > 1e-6f ? 1.0f / s.uy : 0.0f;
+    s.lastDisc = last;
+    return s;
+}
+
+// Interval of x where u * x + c lies in [lo, hi], given inv = 1 / u (or 0
+// when u is 0 and the value does not depend on x)
+static inline bool LinearRange(float inv, float c, float lo, float hi, float& x0, float& x1) {
+    if (inv == 0.0f) {
+        if (c < lo || c > hi) return false;
+        x0 = -1e30f; x1 = 1e30f;
+        return true;
+    }
+    float p = (lo - c) * inv, q = (hi - c) * inv;
+    x0 = p < q ? p : q;
+    x1 = p < q ? q : p;
+    return true;
+}
+
+// Span of row y inside the capsule around a segment: the union of the end
+// discs and the rectangle between them, which is one interval because the
+// capsule is convex. Joined segments share discs, so each segment only
+// adds the disc at its start (and the last one the disc at its end).
+static bool CapsuleSpan(const SpanSegment& s, float radius, float y, float& x0, float& x1) {
+    float r2 = radius * radius;
+    bool any = false;
+    x0 = 1e30f; x1 = -1e30f;
+
+    float dy = y - s.ay;
+    if (dy * dy <= r2) {
+        float half = sqrtf(r2 - dy * dy);
+        x0 = s.ax - half; x1 = s.ax + half;
+        any = true;
+    }
+    if (s.lastDisc) {
+        float ey = y - s.by;
+        if (ey * ey <= r2) {
+            float half = sqrtf(r2 - ey * ey);
+            x0 = fminf(x0, s.bx - half); x1 = fmaxf(x1, s.bx + half);
+            any = true;
+        }
+    }
+
+    if (s.len > 0.0f) {
+        // Along the segment t in [0, len], across it in [-radius, radius];
+        // both are linear in x on a fixed row
+        float t0, t1, c0, c1;
+        if (LinearRange(s.invUx, -s.ax * s.ux + dy * s.uy, 0.0f, s.len, t0, t1) &&
+            LinearRange(-s.invUy, s.ax * s.uy + dy * s.ux, -radius, radius, c0, c1)) {
+            float lo = fmaxf(t0, c0), hi = fminf(t1, c1);
+            if (lo <= hi) {
+                x0 = fminf(x0, lo);
+                x1 = fmaxf(x1, hi);
+                any = true;
+            }
+        }
+    }
+    return any;
+}
+
+void RasterizeThickPolyline(Image& image, const std::vector<Vector2>& points, float radius, Color color) {
+    if (image.format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 || points.empty()) return;
+    const int w = image.width, h = image.height;
+    const int tilesX = (w + TILE - 1) >> TILE_SHIFT, tilesY = (h + TILE - 1) >> TILE_SHIFT;
+    const int segCount = points.size() > 1 ? (int)points.size() - 1 : 1;
+    std::vector<SpanSegment> segs(segCount);
+    for (int s = 0; s < segCount; s++)
+        segs[s] = PrepareSegment(points[s], points.size() > 1 ? points[s + 1] : points[s], s == segCount - 1);
+
+    // Tile range each segment's bounding box (grown by the radius) touches
+    auto tileRange = [&](int s, int& tx0, int& ty0, int& tx1, int& ty1) {
+        const SpanSegment& g = segs[s];
+        int x0 = (int)floorf(fminf(g.ax, g.bx) - radius), x1 = (int)ceilf(fmaxf(g.ax, g.bx) + radius);
+        int y0 = (int)floorf(fminf(g.ay, g.by) - radius), y1 = (int)ceilf(fmaxf(g.ay, g.by) + radius);
+        if (x1 < 0 || y1 < 0 || x0 >= w || y0 >= h) return false;
+        tx0 = (x0 < 0 ? 0 : x0) >> TILE_SHIFT; tx1 = (x1 >= w ? w - 1 : x1) >> TILE_SHIFT;
+        ty0 = (y0 < 0 ? 0 : y0) >> TILE_SHIFT; ty1 = (y1 >= h ? h - 1 : y1) >> TILE_SHIFT;
+        return true;
+    };
+
+    // Bin segments per tile with a counting sort: count, prefix sum, fill
+    std::vector<int> start(tilesX * tilesY + 1, 0);
+    int tx0, ty0, tx1, ty1;
+    for (int s = 0; s < segCount; s++) {
+        if (!tileRange(s, tx0, ty0, tx1, ty1)) continue;
+        for (int ty = ty0; ty <= ty1; ty++)
+            for (int tx = tx0; tx <= tx1; tx++) start[ty * tilesX + tx + 1]++;
+    }
+    for (int t = 0; t < tilesX * tilesY; t++) start[t + 1] += start[t];
+    std::vector<int> bins(start.back());
+    std::vector<int> fill(start.begin(), start.end() - 1);
+    for (int s = 0; s < segCount; s++) {
+        if (!tileRange(s, tx0, ty0, tx1, ty1)) continue;
+        for (int ty = ty0; ty <= ty1; ty++)
+            for (int tx = tx0; tx <= tx1; tx++) bins[fill[ty * tilesX + tx]++] = s;
+    }
+
+    Color* pixels = (Color*)image.data;
+    uint32_t rows[TILE];
+    for (int ty = 0; ty < tilesY; ty++) {
+        for (int tx = 0; tx < tilesX; tx++) {
+            int t = ty * tilesX + tx;
+            if (start[t] == start[t + 1]) continue;
+
+            const int px0 = tx << TILE_SHIFT, py0 = ty << TILE_SHIFT;
+            const int cols = (w - px0 < TILE) ? w - px0 : TILE;
+            const int lines = (h - py0 < TILE) ? h - py0 : TILE;
+            for (int r = 0; r < lines; r++) rows[r] = 0;
+
+            for (int k = start[t]; k < start[t + 1]; k++) {
+                const SpanSegment& g = segs[bins[k]];
+                int r0 = (int)ceilf(fminf(g.ay, g.by) - radius) - py0;
+                int r1 = (int)floorf(fmaxf(g.ay, g.by) + radius) - py0;
+                if (r0 < 0) r0 = 0;
+                if (r1 > lines - 1) r1 = lines - 1;
+                for (int r = r0; r <= r1; r++) {
+                    float x0, x1;
+                    if (!CapsuleSpan(g, radius, (float)(py0 + r), x0, x1)) continue;
+                    int c0 = (int)ceilf(x0) - px0, c1 = (int)floorf(x1) - px0;
+                    if (c0 < 0) c0 = 0;
+                    if (c1 > cols - 1) c1 = cols - 1;
+                    if (c0 > c1) continue;
+                    int n = c1 - c0 + 1;
+                    rows[r] |= (n == 32 ? 0xffffffffu : ((1u << n) - 1u)) << c0;
+                }
+            }
+
+            for (int r = 0; r < lines; r++) {
+                Color* row = pixels + (size_t)(py0 + r) * w + px0;
+                int c = 0;
+                for (uint32_t m = rows[r]; m; m >>= 1, c++)
+                    if (m & 1) row[c] = color;
+            }
+        }
+    }
+}
@@ -0,0 +1,11 @@
+#pragma once
+#include "raylib.h"
+#include <vector>
+
+// Draw a polyline of the given radius (round joins and caps) into an
+// R8G8B8A8 image. Pixel (x, y) is covered when its integer coordinates lie
+// within radius of a segment, the same rule as ImageDrawCircle stamped
+// along the line. Segments are binned into 32x32 tiles; each tile ORs the
+// exact per-row spans of its segments into a coverage mask and then writes
+// every covered pixel once.
+void RasterizeThickPolyline(Image& image, const std::vector<Vector2>& points, float radius, Color color);
@@ -0,0 +1,165 @@
+#include "PathIndex.h"
+#include <algorithm>
+#include <cmath>
+
+static const int LEAF_SIZE = 4;
+
+void PathIndex::Build(const std::vector<Vector2>& points) {
+    segA.clear(); segB.clear(); cumulative.clear();
+    nodes.clear(); order.clear();
+    if (points.size() < 2) return;
+
+    int n = (int)points.size() - 1;
+    segA.assign(points.begin(), points.end() - 1);
+    segB.assign(points.begin() + 1, points.end());
+    cumulative.resize(n + 1);
+    cumulative[0] = 0.0f;
+    std::vector<Vector2> centres(n);
+    for (int i = 0; i < n; i++) {
+        float dx = segB[i].x - segA[i].x, dy = segB[i].y - segA[i].y;
+        cumulative[i + 1] = cumulative[i] + sqrtf(dx * dx + dy * dy);
+        centres[i] = { (segA[i].x + segB[i].x) * 0.5f, (segA[i].y + segB[i].y) * 0.5f };
+    }
+
+    order.resize(n);
+    for (int i = 0; i < n; i++) order[i] = i;
+    nodes.reserve(2 * (n / LEAF_SIZE + 1));
+    nodes.resize(1);
+    BuildNode(0, 0, n, centres);
+}
+
+// Fill nodes[index] for order[begin, end): bounds, then a median split on
+// the longer axis of the segment centres
+void PathIndex::BuildNode(int index, int begin, int end, std::vector<Vector2>& centres) {
+    Node node;
+    node.minX = node.minY = 1e30f;
+    node.maxX = node.maxY = -1e30f;
+    float cMinX = 1e30f, cMinY = 1e30f, cMaxX = -1e30f, cMaxY = -1e30f;
+    for (int k = begin; k < end; k++) {
+        int s = order[k];
+        node.minX = std::min(node.minX, std::min(segA[s].x, segB[s].x));
+        node.minY = std::min(node.minY, std::min(segA[s].y, segB[s].y));
+        node.maxX = std::max(node.maxX, std::max(segA[s].x, segB[s].x));
+        node.maxY = std::max(node.maxY, std::max(segA[s].y, segB[s].y));
+        cMinX = std::min(cMinX, centres[s].x); cMaxX = std::max(cMaxX, centres[s].x);
+        cMinY = std::min(cMinY, centres[s].y); cMaxY = std::max(cMaxY, centres[s].y);
+    }
+    node.begin = begin;
+    node.end = end;
+    node.left = -1;
+
+    if (end - begin <= LEAF_SIZE) {
+        nodes[index] = node;
+        return;
+    }
+
+    int mid = (begin + end) / 2;
+    bool splitX = (cMaxX - cMinX) >= (cMaxY - cMinY);
+    std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end,
+        [&](int a, int b) { return splitX ? centres[a].x < centres[b].x : centres[a].y < centres[b].y; });
+
+    node.left = (int)nodes.size();
+    nodes[index] = node;
+    nodes.resize(nodes.size() + 2);
+    BuildNode(node.left, begin, mid, centres);
+    BuildNode(node.left + 1, mid, end, centres);
+}
+
+void PathIndex::TestSegment(int s, Vector2 p, float& best, PathHit& hit) const {
+    Vector2 a = segA[s], b = segB[s];
+    float abx = b.x - a.x, aby = b.y - a.y;
+    float len2 = abx * abx + aby * aby;
+    float t = len2 > 0.0f ? ((p.x - a.x) * abx + (p.y - a.y) * aby) / len2 : 0.0f;
+    t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+    float qx = a.x + abx * t, qy = a.y + aby * t;
+    float d2 = (qx - p.x) * (qx - p.x) + (qy - p.y) * (qy - p.y);
+    // Ties go to the lower index so the BVH and the linear scan agree
+    if (d2 < best || (d2 == best && s < hit.segment)) {
+        best = d2;
+        hit.segment = s;
+        hit.t = t;
+        hit.point = { qx, qy };
+    }
+}
+
+// Distance, side and arc length from the winning segment
+static void FinishHit(PathHit& hit, Vector2 p, float best, const std::vector<Vector2>& segA,
+                      const std::vector<Vector2>& segB, const std::vector<float>& cumulative) {
+    int s = hit.segment;
+    hit.distance = sqrtf(best);
+    float abx = segB[s].x - segA[s].x, aby = segB[s].y - segA[s].y;
+    // Right of travel is (-dy, dx) in screen coordinates (y down)
+    float side = (p.x - hit.point.x) * -aby + (p.y - hit.point.y) * abx;
+    hit.offset = side < 0.0f ? -hit.distance : hit.distance;
+    hit.arcLength = cumulative[s] + (cumulative[s + 1] - cumulative[s]) * hit.t;
+}
+
+PathHit PathIndex::Closest(Vector2 p, int hint) const {
+    PathHit hit = {};
+    hit.segment = -1;
+    if (nodes.empty()) return hit;
+
+    float best = 1e30f;
+    if (hint >= 0 && hint < Segments()) TestSegment(hint, p, best, hit);
+
+    auto boxDist2 = [&](const Node& n) {
+        float dx = std::max(std::max(n.minX - p.x, p.x - n.maxX), 0.0f);
+        float dy = std::max(std::max(n.minY - p.y, p.y - n.maxY), 0.0f);
+        return dx * dx + dy * dy;
+    };
+
+    int stack[64];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node& n = nodes[stack[--top]];
+        if (boxDist2(n) > best) continue;
+        if (n.left < 0) {
+            for (int k = n.begin; k < n.end; k++) TestSegment(order[k], p, best, hit);
+            continue;
+        }
+        // Visit the nearer child first: push it last
+        float dl = boxDist2(nodes[n.left]), dr = boxDist2(nodes[n.left + 1]);
+        if (dl <= dr) {
+            if (dr <= best) stack[top++] = n.left + 1;
+            if (dl <= best) stack[top++] = n.left;
+        } else {
+            if (dl <= best) stack[top++] = n.left;
+            if (dr <= best) stack[top++] = n.left + 1;
+        }
+    }
+
+    FinishHit(hit, p, best, segA, segB, cumulative);
+    return hit;
+}
+
+PathHit PathIndex::ClosestBruteForce(Vector2 p) const {
+    PathHit hit = {};
+    hit.segment = -1;
+    if (segA.empty()) return hit;
+    float best = 1e30f;
+    for (int s = 0; s < Segments(); s++) TestSegment(s, p, best, hit);
+    FinishHit(hit, p, best, segA, segB, cumulative);
+    return hit;
+}
+
+Vector2 PathIndex::PointAt(float arcLength, float* heading) const {
+    if (segA.empty()) return { 0.0f, 0.0f };
+    float total = Length();
+    float s = total > 0.0f ? fmodf(arcLength, total) : 0.0f;
+    if (s < 0.0f) s += total;
+
+    // First segment whose end lies beyond s
+    int i = (int)(std::upper_bound(cumulative.begin() + 1, cumulative.end(), s) - cumulative.begin()) - 1;
+    if (i >= Segments()) i = Segments() - 1;
+    float len = cumulative[i + 1] - cumulative[i];
+    float t = len > 0.0f ? (s - cumulative[i]) / len : 0.0f;
+    Vector2 a = segA[i], b = segB[i];
+    if (heading) *heading = atan2f(b.y - a.y, b.x - a.x);
+    return { a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t };
+}
+
+size_t PathIndex::MemoryBytes() const {
+    return (segA.capacity() + segB.capacity()) * sizeof(Vector2) + cumulative.capacity() * sizeof(float) +
+           nodes.capacity() * sizeof(Node) + order.capacity() * sizeof(int);
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "raylib.h"
+#include <vector>
+
+// Nearest point of the path to a query point
+struct PathHit {
+    Vector2 point;      // closest point on the path
+    int segment;        // segment index (points[segment] -> points[segment + 1])
+    float t;            // position along that segment, 0..1
+    float distance;     // unsigned distance to the path
+    float offset;       // signed: positive to the right of the direction of travel
+    float arcLength;    // path length from points[0] to the closest point
+};
+
+// Bounding-volume hierarchy over the segments of a polyline. Answers
+// closest-point, signed-offset and arc-length queries in O(log n) for
+// well-spread paths. Read-only after Build, so any number of threads can
+// query it at once.
+class PathIndex {
+public:
+    void Build(const std::vector<Vector2>& points);
+
+    int Segments() const { return (int)segA.size(); }
+    float Length() const { return cumulative.empty() ? 0.0f : cumulative.back(); }
+
+    // hint: a segment that is probably close (last tick's answer). It
+    // seeds the search bound so most of the tree is pruned at once.
+    PathHit Closest(Vector2 p, int hint = -1) const;
+
+    // Point at a given arc length, wrapping around for closed tracks
+    Vector2 PointAt(float arcLength, float* heading = nullptr) const;
+
+    // Reference linear scan over every segment
+    PathHit ClosestBruteForce(Vector2 p) const;
+
+    size_t MemoryBytes() const;
+
+private:
+    struct Node {
+        float minX, minY, maxX, maxY;
+        int left;           // first child (right child is left + 1), or -1 for a leaf
+        int begin, end;     // leaf range in order
+    };
+
+    std::vector<Vector2> segA, segB;
+    std::vector<float> cumulative;   // arc length at the start of each segment, plus the total
+    std::vector<Node> nodes;
+    std::vector<int> order;          // segment indices, grouped by leaf
+
+    void BuildNode(int index, int begin, int end, std::vector<Vector2>& centres);
+    void TestSegment(int s, Vector2 p, float& best, PathHit& hit) const;
+};
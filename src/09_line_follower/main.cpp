@@ -1,6 +1,18 @@
 #include "raylib.h"
 #include <vector>
+#include <chrono>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <algorithm>
+#include "LineField.h"
+#include "LineRaster.h"
+#include "PathIndex.h"
+#include "FollowerBatch.h"
+#include "ThreadPool.h"
 
 // --- Vector helper functions ---
 // Add two Vector2 structs
@@ -30,7 +42,7 @@ Vector2 CubicBezier(Vector2 p0, Vector2 p1, Vector2 p2, Vector2 p3, float t) {
 
 // --- Line detection ---
 // Check if a given pixel position corresponds to the black path
-bool IsOnLine(Vector2 p, Image &lineImage) {
+bool IsOnLine(Vector2 p, const Image &lineImage) {
     // If the point is out of bounds, consider it off the line
     if (p.x < 0 || p.y < 0 || p.x >= lineImage.width || p.y >= lineImage.height)
         return false;
@@ -39,9 +51,14 @@ bool IsOnLine(Vector2 p, Image &lineImage) {
     return (c.r < 50 && c.g < 50 && c.b < 50);
 }
 
+// Same test against the precomputed 1-bit mask
+bool IsOnLine(Vector2 p, const LineField &field) { return field.OnLine(p); }
+
 // --- Line-following sensor ---
-// Computes the average horizontal offset of the path under multiple forward-facing sensors
-float LinePositionError(Robot &bot, Image &lineImage, int numSamples = 7, float scanWidth = 20.0f, float lookAhead = 15.0f) {
+// Computes the average horizontal offset of the path under multiple forward-facing sensors.
+// Works on the raw image or the bit mask; kept for comparison in --bench.
+template <typename Line>
+float LinePositionErrorSampled(const Robot &bot, const Line &line, int numSamples = 7, float scanWidth = 20.0f, float lookAhead = 15.0f) {
     // Forward direction vector based on current heading
     Vector2 forward = { cosf(bot.angle), sinf(bot.angle) };
     // Right vector perpendicular to forward direction
@@ -56,7 +73,7 @@ float LinePositionError(Robot &bot, Image &lineImage, int numSamples = 7, float
         Vector2 samplePos = Vector2Add(bot.pos, Vector2Scale(forward, lookAhead)); // forward
         samplePos = Vector2Add(samplePos, Vector2Scale(right, offset));            // offset sideways
 
-        if (IsOnLine(samplePos, lineImage)) {
+        if (IsOnLine(samplePos, line)) {
             errorSum += offset;
             hitCount++;
         }
@@ -66,14 +83,15 @@ float LinePositionError(Robot &bot, Image &lineImage, int numSamples = 7, float
     return errorSum / hitCount;      // return average horizontal offset as error
 }
 
-int main() {
-    const int screenW = 1024;
-    const int screenH = 775;
-
-    InitWindow(screenW, screenH, "Robot Following Exact Bezier Path");
-    SetTargetFPS(60);
+// Sub-pixel lateral offset of the line's centre under the sensor bar,
+// positive to the right (see LineField::LateralError)
+float LinePositionError(const Robot &bot, const LineField &field, float scanWidth = 20.0f, float lookAhead = 15.0f) {
+    return field.LateralError(bot.pos, bot.angle, scanWidth, lookAhead);
+}
 
-    // --- Generate the exact path points (copied from Code 1) ---
+// --- Track ---
+// The exact path points, centred in a w x h window
+std::vector<Vector2> BuildTrack(int screenW, int screenH) {
     std::vector<Vector2> pathPoints;
     pathPoints.push_back({100, 100});   // Start point
     pathPoints.push_back({400, 100});   // Horizontal line to the right
@@ -129,10 +147,20 @@ int main() {
     float dx = screenW/2.0f - (minX+maxX)/2.0f;
     float dy = screenH/2.0f - (minY+maxY)/2.0f;
     for(auto &pt:pathPoints){ pt.x+=dx; pt.y+=dy; }
+    return pathPoints;
+}
 
-    // --- Draw the path to an image for pixel-perfect robot detection ---
+// Draw the path into a white image, black where the line is. Each covered
+// pixel is written once by the tiled span rasteriser.
+Image RasterizePath(const std::vector<Vector2> &pathPoints, int screenW, int screenH, float thickness) {
+    Image lineImage = GenImageColor(screenW, screenH, WHITE); // white background
+    RasterizeThickPolyline(lineImage, pathPoints, (float)(int)(thickness/2), BLACK);
+    return lineImage;
+}
+
+// Original rasteriser: a circle stamped at every pixel step, kept for --bench
+Image RasterizePathCircles(const std::vector<Vector2> &pathPoints, int screenW, int screenH, float thickness) {
     Image lineImage = GenImageColor(screenW, screenH, WHITE); // white background
-    const float PATH_THICK = 18.0f;                            // thickness of path
     for(size_t i=1;i<pathPoints.size();i++){
         Vector2 diff = { pathPoints[i].x - pathPoints[i-1].x, pathPoints[i].y - pathPoints[i-1].y };
         float length = sqrtf(diff.x*diff.x + diff.y*diff.y);
@@ -142,10 +170,380 @@ int main() {
             float t = s/(float)steps;
             int px = (int)(pathPoints[i-1].x + diff.x * t);
             int py = (int)(pathPoints[i-1].y + diff.y * t);
-            ImageDrawCircle(&lineImage, px, py, PATH_THICK/2, BLACK);
+            ImageDrawCircle(&lineImage, px, py, thickness/2, BLACK);
+        }
+    }
+    return lineImage;
+}
+
+// --- Robot update ---
+// One frame: head for home until the robot reaches the line, then steer by
+// the lateral error that error(bot) reports
+template <typename ErrorFn>
+void StepRobot(Robot &bot, bool &foundLine, const LineField &field, Vector2 home, float Kp, ErrorFn error) {
+    if(!foundLine){
+        // If the robot hasn't found the path yet, move it toward the center
+        Vector2 toCenter = { home.x - bot.pos.x, home.y - bot.pos.y };
+        float dist = sqrtf(toCenter.x*toCenter.x + toCenter.y*toCenter.y);
+        if(dist>1.0f){
+            bot.angle = atan2f(toCenter.y, toCenter.x);
+            bot.pos.x += cosf(bot.angle) * bot.speed;
+            bot.pos.y += sinf(bot.angle) * bot.speed;
+        }
+        // Check if we reached the path
+        if(IsOnLine(bot.pos, field))
+            foundLine = true;
+    } else {
+        // --- Normal line-following behavior ---
+        bot.angle += error(bot) * Kp;  // adjust heading
+        bot.pos.x += cosf(bot.angle) * bot.speed;
+        bot.pos.y += sinf(bot.angle) * bot.speed;
+    }
+}
+
+// --- Benchmark ---
+// Wall-clock seconds since start. The benchmarks run before any window is
+// open, and raylib's GetTime() reads 0 until one is.
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Sensor queries per second (raw image, bit mask, distance field) and how
+// the P controller tracks the line with each error signal
+int RunBenchmark(int screenW, int screenH) {
+    std::vector<Vector2> pathPoints = BuildTrack(screenW, screenH);
+    Image lineImage = RasterizePath(pathPoints, screenW, screenH, 18.0f);
+
+    auto start = std::chrono::steady_clock::now();
+    LineField field(lineImage);
+    double buildMs = SecondsSince(start) * 1000.0;
+    PathIndex index;
+    index.Build(pathPoints);
+    printf("%dx%d track: mask + SDF built in %.1f ms, %.2f MB (image %.2f MB)\n",
+           screenW, screenH, buildMs, field.MemoryBytes() / (1024.0 * 1024.0),
+           screenW * screenH * 4 / (1024.0 * 1024.0));
+
+    // Poses near the line, as the follower sees them
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<int> seg(1, (int)pathPoints.size() - 1);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f), side(-12.0f, 12.0f), turn(-0.5f, 0.5f);
+    std::vector<Robot> poses(100000);
+    for (auto &r : poses) {
+        int i = seg(gen);
+        Vector2 a = pathPoints[i-1], b = pathPoints[i];
+        float t = unit(gen), heading = atan2f(b.y - a.y, b.x - a.x);
+        r.pos = { a.x + (b.x - a.x) * t - sinf(heading) * side(gen), a.y + (b.y - a.y) * t + cosf(heading) * side(gen) };
+        r.angle = heading + turn(gen);
+        r.speed = 2.0f;
+    }
+
+    printf("sensor               queries/s   (9 samples each for the sampled sensors)\n");
+    const int REPEAT = 10;
+    double sink = 0.0;
+    start = std::chrono::steady_clock::now();
+    for (int k = 0; k < REPEAT; k++)
+        for (auto &r : poses) sink += LinePositionErrorSampled(r, lineImage, 9, 28.0f, 15.0f);
+    double imageRate = REPEAT * poses.size() / SecondsSince(start);
+    start = std::chrono::steady_clock::now();
+    for (int k = 0; k < REPEAT; k++)
+        for (auto &r : poses) sink += LinePositionErrorSampled(r, field, 9, 28.0f, 15.0f);
+    double maskRate = REPEAT * poses.size() / SecondsSince(start);
+    start = std::chrono::steady_clock::now();
+    for (int k = 0; k < REPEAT; k++)
+        for (auto &r : poses) sink += LinePositionError(r, field, 28.0f, 15.0f);
+    double sdfRate = REPEAT * poses.size() / SecondsSince(start);
+    printf("image samples  %13.0f\n", imageRate);
+    printf("mask samples   %13.0f  %5.1fx\n", maskRate, maskRate / imageRate);
+    printf("SDF difference %13.0f  %5.1fx  (checksum %.0f)\n", sdfRate, sdfRate / imageRate, sink);
+
+    // Tracking: start on the first segment and run for a while
+    printf("error signal   mean off-centre  RMS     max   frames off line  mean |turn|/frame  laps\n");
+    const int FRAMES = 30000;
+    for (int mode = 0; mode < 2; mode++) {
+        Robot bot;
+        bot.pos = pathPoints[0];
+        bot.angle = atan2f(pathPoints[1].y - pathPoints[0].y, pathPoints[1].x - pathPoints[0].x);
+        bot.speed = 2.0f;
+        bool foundLine = true;
+        double sum = 0.0, sumSq = 0.0, worst = 0.0, turning = 0.0;
+        int offLine = 0, laps = 0, hint = -1;
+        bool away = false;
+        for (int f = 0; f < FRAMES; f++) {
+            float before = bot.angle;
+            if (mode == 0)
+                StepRobot(bot, foundLine, field, {0, 0}, 0.06f, [&](const Robot &b) { return LinePositionErrorSampled(b, field, 9, 28.0f, 15.0f); });
+            else
+                StepRobot(bot, foundLine, field, {0, 0}, 0.06f, [&](const Robot &b) { return LinePositionError(b, field, 28.0f, 15.0f); });
+            turning += fabsf(bot.angle - before);
+
+            PathHit hit = index.Closest(bot.pos, hint);
+            hint = hit.segment;
+            double off = hit.distance;
+            sum += off; sumSq += off * off;
+            if (off > worst) worst = off;
+            offLine += !field.OnLine(bot.pos);
+
+            float dx = bot.pos.x - pathPoints[0].x, dy = bot.pos.y - pathPoints[0].y;
+            float d2 = dx * dx + dy * dy;
+            if (d2 > 200.0f * 200.0f) away = true;
+            if (away && d2 < 20.0f * 20.0f) { laps++; away = false; }
+        }
+        printf("%-13s  %15.2f  %5.2f  %6.2f  %15d  %17.4f  %4d\n", mode == 0 ? "9 samples" : "SDF",
+               sum / FRAMES, sqrt(sumSq / FRAMES), worst, offLine, turning / FRAMES, laps);
+    }
+
+    UnloadImage(lineImage);
+    return 0;
+}
+
+// Startup cost of building the line image: the stamped circles vs the
+// tiled rasteriser, on the real track and on a 10,000-segment curve at 4K.
+// Both must cover the same pixels up to the circles' rounding of each
+// stamp centre to whole pixels.
+int RunRasterBenchmark(int screenW, int screenH) {
+    struct Case { const char* name; int w, h; std::vector<Vector2> points; };
+    std::vector<Case> cases;
+    cases.push_back({ "track", screenW, screenH, BuildTrack(screenW, screenH) });
+
+    // Lissajous curve filling a 3840x2160 frame
+    Case big = { "10k segments", 3840, 2160, {} };
+    for (int i = 0; i <= 10000; i++) {
+        float t = i / 10000.0f * 2 * PI;
+        big.points.push_back({ 1920.0f + 1800.0f * sinf(3 * t + 0.5f), 1080.0f + 1000.0f * sinf(4 * t) });
+    }
+    cases.push_back(big);
+
+    // Times include GenImageColor; the blank column is that part alone
+    printf("path           size       blank ms  circles ms  tiled ms  draw speedup  pixels differ  field ms\n");
+    for (const Case &c : cases) {
+        auto start = std::chrono::steady_clock::now();
+        Image blank = GenImageColor(c.w, c.h, WHITE);
+        double blankMs = SecondsSince(start) * 1000.0;
+        UnloadImage(blank);
+
+        start = std::chrono::steady_clock::now();
+        Image circles = RasterizePathCircles(c.points, c.w, c.h, 18.0f);
+        double circleMs = SecondsSince(start) * 1000.0;
+
+        start = std::chrono::steady_clock::now();
+        Image tiled = RasterizePath(c.points, c.w, c.h, 18.0f);
+        double tiledMs = SecondsSince(start) * 1000.0;
+
+        start = std::chrono::steady_clock::now();
+        LineField field(tiled);
+        double fieldMs = SecondsSince(start) * 1000.0;
+
+        long differ = 0;
+        Color *a = (Color *)circles.data, *b = (Color *)tiled.data;
+        for (long i = 0; i < (long)c.w * c.h; i++) differ += (a[i].r != b[i].r);
+
+        double speedup = (circleMs - blankMs) / fmax(tiledMs - blankMs, 1e-3);
+        printf("%-13s  %4dx%-4d  %8.1f  %10.1f  %8.1f  %11.1fx  %13ld  %8.1f\n", c.name, c.w, c.h,
+               blankMs, circleMs, tiledMs, speedup, differ, fieldMs);
+        UnloadImage(circles);
+        UnloadImage(tiled);
+    }
+    return 0;
+}
+
+// Closest-point queries: BVH vs linear scan, on the track and on long
+// generated curves. Every BVH answer must match the scan.
+int RunPathBenchmark(int screenW, int screenH, int segments) {
+    struct Case { const char* name; std::vector<Vector2> points; };
+    std::vector<Case> cases;
+    cases.push_back({ "track", BuildTrack(screenW, screenH) });
+
+    // Dense Lissajous curve that keeps crossing itself, in a 4K frame
+    for (int n : { 10000, segments }) {
+        Case c = { n == 10000 ? "10k segments" : "long curve", {} };
+        for (int i = 0; i <= n; i++) {
+            float t = i / (float)n * 2 * PI;
+            c.points.push_back({ 1920.0f + 1800.0f * sinf(7 * t + 0.5f), 1080.0f + 1000.0f * sinf(9 * t) });
         }
+        cases.push_back(c);
     }
 
+    printf("path           segments  build ms   scan q/s      BVH q/s   hinted q/s  speedup  mismatches\n");
+    bool allMatch = true;
+    for (const Case &c : cases) {
+        PathIndex index;
+        auto start = std::chrono::steady_clock::now();
+        index.Build(c.points);
+        double buildMs = SecondsSince(start) * 1000.0;
+
+        // Queries near the path, as a follower would make them: walk along
+        // it with a sideways wobble, so consecutive queries are close
+        std::mt19937 gen(9);
+        std::uniform_real_distribution<float> side(-30.0f, 30.0f);
+        std::vector<Vector2> queries(20000);
+        for (size_t i = 0; i < queries.size(); i++) {
+            float heading;
+            Vector2 p = index.PointAt(index.Length() * i / queries.size(), &heading);
+            float o = side(gen);
+            queries[i] = { p.x - sinf(heading) * o, p.y + cosf(heading) * o };
+        }
+
+        // The scan is slow on long paths; time it on a subset
+        size_t scanCount = c.points.size() > 20000 ? 200 : queries.size();
+        std::vector<PathHit> reference(scanCount);
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < scanCount; i++) reference[i] = index.ClosestBruteForce(queries[i]);
+        double scanRate = scanCount / SecondsSince(start);
+
+        std::vector<PathHit> hits(queries.size());
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < queries.size(); i++) hits[i] = index.Closest(queries[i]);
+        double bvhRate = queries.size() / SecondsSince(start);
+
+        int hint = -1;
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < queries.size(); i++) hint = index.Closest(queries[i], hint).segment;
+        double hintRate = queries.size() / SecondsSince(start);
+
+        int mismatches = 0;
+        for (size_t i = 0; i < scanCount; i++)
+            if (hits[i].segment != reference[i].segment || hits[i].distance != reference[i].distance ||
+                hits[i].offset != reference[i].offset || hits[i].arcLength != reference[i].arcLength) mismatches++;
+        allMatch = allMatch && mismatches == 0;
+
+        printf("%-13s  %8d  %8.1f  %9.0f  %11.0f  %11.0f  %6.0fx  %10d\n", c.name, index.Segments(), buildMs,
+               scanRate, bvhRate, hintRate, hintRate / scanRate, mismatches);
+    }
+    printf("%s\n", allMatch ? "BVH matches the linear scan" : "BVH DIFFERS FROM THE LINEAR SCAN");
+    return allMatch ? 0 : 1;
+}
+
+// Headless batch: thousands of followers with P, PI and PD gains from a
+// grid, several start poses each, all on the same track. Scores each gain
+// set on first-lap time and mean lateral offset, and reports robot-steps
+// per second for 1..N threads (results must not depend on the count).
+int RunBatch(int screenW, int screenH, int frames, int maxThreads) {
+    std::vector<Vector2> pathPoints = BuildTrack(screenW, screenH);
+    Image lineImage = RasterizePath(pathPoints, screenW, screenH, 18.0f);
+    LineField field(lineImage);
+    UnloadImage(lineImage);
+    PathIndex path;
+    path.Build(pathPoints);
+
+    struct Setting { const char* type; Gains g; };
+    std::vector<Setting> settings;
+    for (int i = 1; i <= 40; i++) settings.push_back({ "P", { 0.005f * i, 0.0f, 0.0f } });
+    for (int i = 1; i <= 20; i++)
+        for (float ki : { 1e-5f, 3e-5f, 1e-4f, 3e-4f, 1e-3f, 3e-3f, 1e-2f, 3e-2f })
+            settings.push_back({ "PI", { 0.01f * i, ki, 0.0f } });
+    for (int i = 1; i <= 20; i++)
+        for (float kd : { 0.02f, 0.05f, 0.1f, 0.2f, 0.4f, 0.8f, 1.2f, 1.6f })
+            settings.push_back({ "PD", { 0.01f * i, 0.0f, kd } });
+
+    // Start poses spread along the track, a little off-centre and skewed
+    const int STARTS = 8;
+    std::mt19937 gen(21);
+    std::uniform_real_distribution<float> side(-5.0f, 5.0f), skew(-0.2f, 0.2f);
+    std::vector<Vector2> startPos;
+    std::vector<float> startHeading;
+    for (int k = 0; k < STARTS; k++) {
+        float heading;
+        Vector2 p = path.PointAt(path.Length() * k / STARTS, &heading);
+        float o = side(gen);
+        startPos.push_back({ p.x - sinf(heading) * o, p.y + cosf(heading) * o });
+        startHeading.push_back(heading + skew(gen));
+    }
+
+    std::vector<Gains> gains;
+    std::vector<Vector2> starts;
+    std::vector<float> headings;
+    for (const Setting &st : settings)
+        for (int k = 0; k < STARTS; k++) {
+            gains.push_back(st.g);
+            starts.push_back(startPos[k]);
+            headings.push_back(startHeading[k]);
+        }
+
+    std::vector<int> threadCounts;
+    for (int t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    printf("%zu gain sets x %d starts = %zu robots, %d frames, track %.0f px\n",
+           settings.size(), STARTS, gains.size(), frames, path.Length());
+    printf("threads  robot-steps/s  speedup  matches 1 thread\n");
+    FollowerBatch batch;
+    std::vector<float> reference;
+    double baseRate = 0.0;
+    for (int t : threadCounts) {
+        ThreadPool pool(t);
+        batch = FollowerBatch();
+        batch.Spawn(gains, starts, headings, path);
+        auto start = std::chrono::steady_clock::now();
+        for (int f = 0; f < frames; f++) batch.Step(f, field, path, &pool);
+        double rate = (double)batch.Size() * frames / SecondsSince(start);
+        if (t == 1) { baseRate = rate; reference = batch.x; }
+        printf("%7d  %13.0f  %6.2fx  %s\n", t, rate, rate / baseRate, batch.x == reference ? "yes" : "NO");
+    }
+
+    // Per gain set: laps completed, mean lap time, mean |offset|
+    struct Score { const Setting* st; int laps; float lapSeconds, offset; };
+    std::vector<Score> scores;
+    for (size_t s = 0; s < settings.size(); s++) {
+        Score sc = { &settings[s], 0, 0.0f, 0.0f };
+        for (int k = 0; k < STARTS; k++) {
+            int i = (int)s * STARTS + k;
+            if (batch.lapFrame[i] >= 0 && !batch.lost[i]) { sc.laps++; sc.lapSeconds += batch.lapFrame[i] / 60.0f; }
+            sc.offset += batch.MeanOffset(i) / STARTS;
+        }
+        if (sc.laps > 0) sc.lapSeconds /= sc.laps;
+        scores.push_back(sc);
+    }
+    std::sort(scores.begin(), scores.end(), [](const Score &a, const Score &b) {
+        if (a.laps != b.laps) return a.laps > b.laps;
+        return a.offset < b.offset;
+    });
+
+    printf("type      kp       ki     kd  laps  lap s  mean |offset| px\n");
+    for (const char* type : { "P", "PI", "PD" }) {
+        int shown = 0;
+        for (const Score &sc : scores) {
+            if (strcmp(sc.st->type, type) != 0 || shown == 3) continue;
+            printf("%-4s  %6.3f  %7.5f  %5.2f  %2d/%d  %5.1f  %16.2f\n", type, sc.st->g.kp, sc.st->g.ki,
+                   sc.st->g.kd, sc.laps, STARTS, sc.lapSeconds, sc.offset);
+            shown++;
+        }
+    }
+    for (const Score &sc : scores)
+        if (strcmp(sc.st->type, "P") == 0 && fabsf(sc.st->g.kp - 0.06f) < 1e-4f)
+            printf("current Kp = 0.06: %d/%d laps, %.1f s, %.2f px mean |offset|\n",
+                   sc.laps, STARTS, sc.lapSeconds, sc.offset);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    const int screenW = 1024;
+    const int screenH = 775;
+
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0)
+        return RunBenchmark(screenW, screenH);
+    if (argc > 1 && strcmp(argv[1], "--bench-raster") == 0)
+        return RunRasterBenchmark(screenW, screenH);
+    if (argc > 1 && strcmp(argv[1], "--batch") == 0) {
+        int frames = argc > 2 ? atoi(argv[2]) : 2400;
+        int threads = argc > 3 ? atoi(argv[3]) : (int)std::thread::hardware_concurrency();
+        return RunBatch(screenW, screenH, frames, threads > 0 ? threads : 1);
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-path") == 0)
+        return RunPathBenchmark(screenW, screenH, argc > 2 ? atoi(argv[2]) : 100000);
+
+    InitWindow(screenW, screenH, "Robot Following Exact Bezier Path");
+    SetTargetFPS(60);
+
+    std::vector<Vector2> pathPoints = BuildTrack(screenW, screenH);
+
+    // --- Draw the path to an image for pixel-perfect robot detection ---
+    const float PATH_THICK = 18.0f;                            // thickness of path
+    Image lineImage = RasterizePath(pathPoints, screenW, screenH, PATH_THICK);
+    LineField lineField(lineImage);                            // mask + signed distance field, baked once
+    PathIndex pathIndex;                                       // analytic distance / progress along the path
+    pathIndex.Build(pathPoints);
+    int pathHint = -1;
+
     Texture2D lineTexture = LoadTextureFromImage(lineImage);
 
     // --- Initialize the robot ---
@@ -156,6 +554,7 @@ int main() {
 
     bool foundLine = false; // has the robot found the path yet?
     float Kp = 0.06f;       // proportional gain for line-following steering
+    Vector2 home = { screenW/2.0f, screenH/2.0f };
 
     // --- Main loop ---
     while(!WindowShouldClose()){
@@ -165,25 +564,9 @@ int main() {
             foundLine = false; // need to reacquire the path
         }
 
-        if(!foundLine){
-            // If the robot hasn't found the path yet, move it toward the center
-            Vector2 toCenter = { screenW/2.0f - bot.pos.x, screenH/2.0f - bot.pos.y };
-            float dist = sqrtf(toCenter.x*toCenter.x + toCenter.y*toCenter.y);
-            if(dist>1.0f){
-                bot.angle = atan2f(toCenter.y, toCenter.x);
-                bot.pos.x += cosf(bot.angle) * bot.speed;
-                bot.pos.y += sinf(bot.angle) * bot.speed;
-            }
-            // Check if we reached the path
-            if(IsOnLine(bot.pos, lineImage))
-                foundLine = true;
-        } else {
-            // --- Normal line-following behavior ---
-            float error = LinePositionError(bot, lineImage, 9, 28.0f, 15.0f); // compute lateral error
-            bot.angle += error * Kp;  // adjust heading
-            bot.pos.x += cosf(bot.angle) * bot.speed;
-            bot.pos.y += sinf(bot.angle) * bot.speed;
-        }
+        StepRobot(bot, foundLine, lineField, home, Kp, [&](const Robot &b) {
+            return LinePositionError(b, lineField, 28.0f, 15.0f); // compute lateral error
+        });
 
         // --- Drawing ---
         BeginDrawing();
@@ -202,11 +585,21 @@ int main() {
                 float offset = ((float)i/8 - 0.5f)*28.0f;
                 Vector2 samplePos = Vector2Add(bot.pos, Vector2Scale(forward, 15.0f));
                 samplePos = Vector2Add(samplePos, Vector2Scale(rightVec, offset));
-                DrawPixelV(samplePos, IsOnLine(samplePos, lineImage) ? GREEN : GRAY);
+                DrawPixelV(samplePos, IsOnLine(samplePos, lineField) ? GREEN : GRAY);
             }
+            // Where the distance field puts the centre of the line
+            float error = LinePositionError(bot, lineField, 28.0f, 15.0f);
+            Vector2 sensor = Vector2Add(bot.pos, Vector2Scale(forward, 15.0f));
+            DrawCircleV(Vector2Add(sensor, Vector2Scale(rightVec, error)), 3, ORANGE);
         }
 
         DrawText("Robot Following Exact Bezier Path", 10,10,20,DARKGRAY);
+        if(foundLine){
+            PathHit hit = pathIndex.Closest(bot.pos, pathHint);
+            pathHint = hit.segment;
+            DrawText(TextFormat("progress %5.1f%%  offset %+5.1f px", 100.0f * hit.arcLength / pathIndex.Length(), hit.offset),
+                     10, 35, 20, DARKGRAY);
+        }
         EndDrawing();
     }
 
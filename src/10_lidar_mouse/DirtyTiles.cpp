@@ -0,0 +1,58 @@
+#include "DirtyTiles.h"
+#include <algorithm>
+#include <cstring>
+
+void DirtyTiles::Init(int w, int h, int tile) {
+    width = w;
+    height = h;
+    tileSize = tile;
+    tilesX = (w + tile - 1) / tile;
+    tilesY = (h + tile - 1) / tile;
+    dirty.assign((size_t)tilesX * tilesY, 0);
+    dirtyCount = 0;
+    staging.resize((size_t)w * tile);
+}
+
+void DirtyTiles::MarkAll() {
+    std::fill(dirty.begin(), dirty.end(), 1);
+    dirtyCount = (int)dirty.size();
+}
+
+void DirtyTiles::Clear() {
+    std::fill(dirty.begin(), dirty.end(), 0);
+    dirtyCount = 0;
+}
+
+size_t DirtyTiles::Upload(Texture2D texture, const Image& image) {
+    if (dirtyCount == 0) return 0;
+
+    const Color* pixels = (const Color*)image.data;
+    size_t bytes = 0;
+
+    for (int ty = 0; ty < tilesY; ty++) {
+        uint8_t* row = &dirty[(size_t)ty * tilesX];
+        int tx = 0;
+        while (tx < tilesX) {
+            if (!row[tx]) { tx++; continue; }
+
+            // Merge a run of dirty tiles into one rectangle
+            int first = tx;
+            while (tx < tilesX && row[tx]) row[tx++] = 0;
+
+            int x0 = first * tileSize;
+            int y0 = ty * tileSize;
+            int w = std::min(tx * tileSize, width) - x0;
+            int h = std::min(y0 + tileSize, height) - y0;
+
+            // UpdateTextureRec expects the rectangle's pixels packed
+            for (int y = 0; y < h; y++)
+                memcpy(&staging[(size_t)y * w], &pixels[(size_t)(y0 + y) * width + x0], w * sizeof(Color));
+
+            UpdateTextureRec(texture, {(float)x0, (float)y0, (float)w, (float)h}, staging.data());
+            bytes += (size_t)w * h * sizeof(Color);
+        }
+    }
+
+    dirtyCount = 0;
+    return bytes;
+}
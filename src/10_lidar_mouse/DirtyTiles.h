@@ -0,0 +1,33 @@
+#pragma once
+#include <raylib.h>
+#include <cstdint>
+#include <vector>
+
+// Tracks which tiles of an RGBA image changed since the last upload.
+// Upload() merges horizontal runs of dirty tiles into one rectangle each
+// and sends only those with UpdateTextureRec, so a frame that touches a
+// few dozen pixels uploads a few tiles instead of the whole image.
+class DirtyTiles {
+public:
+    void Init(int width, int height, int tileSize = 32);
+
+    void Mark(int x, int y) {
+        int t = (y / tileSize) * tilesX + x / tileSize;
+        if (!dirty[t]) { dirty[t] = 1; dirtyCount++; }
+    }
+    void MarkAll();
+    void Clear();
+    bool Empty() const { return dirtyCount == 0; }
+
+    // Upload the dirty parts of image (R8G8B8A8) to texture, clear the
+    // tracker and return the number of bytes sent
+    size_t Upload(Texture2D texture, const Image& image);
+
+private:
+    int width = 0, height = 0;
+    int tileSize = 32;
+    int tilesX = 0, tilesY = 0;
+    int dirtyCount = 0;
+    std::vector<uint8_t> dirty;   // one flag per tile
+    std::vector<Color> staging;   // packed pixels of one rectangle
+};
@@ -0,0 +1,105 @@
+#include "DistanceField.h"
+#include <cmath>
+#include <limits>
+
+// 1D squared distance transform of f (length n) into d: the lower
+// envelope of parabolas rooted at each sample.
+// v and z are scratch buffers of size n and n + 1.
+static void DistanceTransform1D(const float* f, float* d, int n, int* v, float* z) {
+    const float INF = std::numeric_limits<float>::infinity();
+    int k = 0;
+    v[0] = 0;
+    z[0] = -INF;
+    z[1] = INF;
+    for (int q = 1; q < n; q++) {
+        float s = ((f[q] + (float)q * q) - (f[v[k]] + (float)v[k] * v[k])) / (2.0f * (q - v[k]));
+        while (s <= z[k]) {
+            k--;
+            s = ((f[q] + (float)q * q) - (f[v[k]] + (float)v[k] * v[k])) / (2.0f * (q - v[k]));
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = INF;
+    }
+    k = 0;
+    for (int q = 0; q < n; q++) {
+        while (z[k + 1] < q) k++;
+        float dq = (float)(q - v[k]);
+        d[q] = dq * dq + f[v[k]];
+    }
+}
+
+DistanceField::DistanceField(const Image& map) : width(map.width), height(map.height) {
+    // Large but finite "no wall" value keeps the parabola maths NaN-free
+    const float FAR = 1e12f;
+    dist.assign((size_t)width * height, FAR);
+
+    Color* pixels = LoadImageColors(map);
+    for (int i = 0; i < width * height; i++) {
+        Color c = pixels[i];
+        if (c.r == 0 && c.g == 0 && c.b == 0) dist[i] = 0.0f;
+    }
+    UnloadImageColors(pixels);
+
+    int n = (width > height) ? width : height;
+    std::vector<float> f(n), d(n), z(n + 1);
+    std::vector<int> v(n);
+
+    // Columns, then rows
+    for (int x = 0; x < width; x++) {
+        for (int y = 0; y < height; y++) f[y] = dist[y * width + x];
+        DistanceTransform1D(f.data(), d.data(), height, v.data(), z.data());
+        for (int y = 0; y < height; y++) dist[y * width + x] = d[y];
+    }
+    for (int y = 0; y < height; y++) {
+        float* row = &dist[y * width];
+        DistanceTransform1D(row, d.data(), width, v.data(), z.data());
+        for (int x = 0; x < width; x++) row[x] = sqrtf(d[x]);
+    }
+}
+
+bool DistanceField::CastRay(Vector2 origin, float angle, float range, float& hitDistance, int* steps) const {
+    // Any point whose cell is D from the nearest wall centre is at least
+    // D - sqrt(2) from every wall square, so that far is safe to skip
+    const float SAFE = 1.4143f;
+    const float inf = std::numeric_limits<float>::infinity();
+    float dx = cosf(angle);
+    float dy = -sinf(angle);
+    float invDx = (dx != 0.0f) ? 1.0f / dx : inf;
+    float invDy = (dy != 0.0f) ? 1.0f / dy : inf;
+
+    float t = 0.0f;
+    int ix = (int)floorf(origin.x);
+    int iy = (int)floorf(origin.y);
+    int count = 0;
+    bool hit = false;
+
+    while (t <= range) {
+        count++;
+        // The map is convex: once a ray leaves it, it never comes back
+        if ((unsigned)ix >= (unsigned)width || (unsigned)iy >= (unsigned)height) break;
+
+        float d = dist[iy * width + ix];
+        if (d == 0.0f) { hit = true; break; }
+
+        if (d > SAFE + 1.0f) {
+            // Open space: jump, then find the cell we landed in
+            t += d - SAFE;
+            ix = (int)floorf(origin.x + t * dx);
+            iy = (int)floorf(origin.y + t * dy);
+        } else {
+            // Near a wall: exact step to the next cell boundary
+            float tx = (dx > 0.0f) ? (ix + 1 - origin.x) * invDx
+                     : (dx < 0.0f) ? (ix - origin.x) * invDx : inf;
+            float ty = (dy > 0.0f) ? (iy + 1 - origin.y) * invDy
+                     : (dy < 0.0f) ? (iy - origin.y) * invDy : inf;
+            if (tx < ty) { t = tx; ix += (dx > 0.0f) ? 1 : -1; }
+            else         { t = ty; iy += (dy > 0.0f) ? 1 : -1; }
+        }
+    }
+
+    if (steps) *steps = count;
+    if (hit && t <= range) { hitDistance = t; return true; }
+    return false;
+}
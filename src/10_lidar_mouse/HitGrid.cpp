@@ -0,0 +1,79 @@
+#include "HitGrid.h"
+#include <cstdio>
+
+// Alpha ramps up over the first hits so repeated returns stand out
+static unsigned char HitAlpha(uint16_t count) {
+    int a = 80 + 5 * count;
+    return (unsigned char)(a > 255 ? 255 : a);
+}
+
+void HitGrid::Init(int w, int h) {
+    width = w;
+    height = h;
+    occupied = 0;
+    counts.assign((size_t)w * h, 0);
+    image = GenImageColor(w, h, BLANK);
+    texture = LoadTextureFromImage(image);
+    dirty.Init(w, h);
+}
+
+void HitGrid::Unload() {
+    UnloadTexture(texture);
+    UnloadImage(image);
+    image = {};
+    texture = {};
+}
+
+int HitGrid::AddHit(Vector2 p) {
+    if (p.x < 0 || p.y < 0 || p.x >= width || p.y >= height) return 0;
+    int i = (int)p.y * width + (int)p.x;
+
+    uint16_t& c = counts[i];
+    if (c == 0xffff) return 0;
+    if (c == 0) occupied++;
+    c++;
+
+    // Only touch the pixel while its colour still changes
+    unsigned char alpha = HitAlpha(c);
+    Color* pixels = (Color*)image.data;
+    if (pixels[i].a != alpha) {
+        pixels[i] = {RED.r, RED.g, RED.b, alpha};
+        dirty.Mark((int)p.x, (int)p.y);
+    }
+    return c;
+}
+
+size_t HitGrid::UploadTexture(bool fullUpload) {
+    if (!fullUpload) return dirty.Upload(texture, image);
+    UpdateTexture(texture, image.data);
+    dirty.Clear();
+    return (size_t)width * height * sizeof(Color);
+}
+
+void HitGrid::Draw() const {
+    DrawTexture(texture, 0, 0, WHITE);
+}
+
+size_t HitGrid::MemoryBytes() const {
+    return counts.size() * sizeof(uint16_t) + (size_t)width * height * sizeof(Color);
+}
+
+std::vector<Vector2> HitGrid::Points() const {
+    std::vector<Vector2> points;
+    points.reserve(occupied);
+    for (int y = 0; y < height; y++)
+        for (int x = 0; x < width; x++)
+            if (counts[y * width + x]) points.push_back({x + 0.5f, y + 0.5f});
+    return points;
+}
+
+bool HitGrid::ExportPoints(const char* filename) const {
+    FILE* f = fopen(filename, "w");
+    if (!f) return false;
+    fprintf(f, "x,y,hits\n");
+    for (int y = 0; y < height; y++)
+        for (int x = 0; x < width; x++)
+            if (counts[y * width + x]) fprintf(f, "%.1f,%.1f,%u\n", x + 0.5f, y + 0.5f, counts[y * width + x]);
+    fclose(f);
+    return true;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <raylib.h>
+#include "DirtyTiles.h"
+#include <cstdint>
+#include <vector>
+
+// Fixed-size grid of LIDAR hit counts at map resolution.
+// Replaces an ever-growing point cloud: memory and draw cost depend only
+// on the map size, not on how long the scan has been running. The grid
+// is mirrored into one RGBA image/texture and drawn with a single call.
+class HitGrid {
+public:
+    void Init(int width, int height);   // needs a window (creates a texture)
+    void Unload();
+
+    // Count a hit at p and return the cell's new count
+    // (0 for points off the map or saturated cells)
+    int AddHit(Vector2 p);
+
+    // Push changed tiles to the GPU (everything if fullUpload) and draw
+    // the whole grid; returns the bytes uploaded
+    size_t UploadTexture(bool fullUpload = false);
+    void Draw() const;
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+    uint16_t Count(int x, int y) const { return counts[y * width + x]; }
+    int OccupiedCells() const { return occupied; }
+    size_t MemoryBytes() const;
+
+    // Deduplicated export: one point (cell centre) per cell with hits
+    std::vector<Vector2> Points() const;
+    bool ExportPoints(const char* filename) const;
+
+private:
+    int width = 0, height = 0;
+    int occupied = 0;
+    std::vector<uint16_t> counts;   // saturating hit counters
+    Image image = {};              // red, alpha grows with the count
+    Texture2D texture = {};
+    DirtyTiles dirty;
+};
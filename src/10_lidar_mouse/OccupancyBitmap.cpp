@@ -0,0 +1,75 @@
+#include "OccupancyBitmap.h"
+#include <cmath>
+#include <limits>
+
+OccupancyBitmap::OccupancyBitmap(int w, int h)
+    : width(w), height(h), wordsPerRow((w + 63) / 64),
+      bits((size_t)((w + 63) / 64) * h, 0) {}
+
+OccupancyBitmap::OccupancyBitmap(const Image& map) : OccupancyBitmap(map.width, map.height) {
+    // Decode the pixel format once for the whole image
+    Color* pixels = LoadImageColors(map);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            Color c = pixels[y * width + x];
+            if (c.r == 0 && c.g == 0 && c.b == 0) Set(x, y, true);
+        }
+    }
+    UnloadImageColors(pixels);
+}
+
+void OccupancyBitmap::Set(int x, int y, bool occupied) {
+    if ((unsigned)x >= (unsigned)width || (unsigned)y >= (unsigned)height) return;
+    uint64_t& word = bits[y * wordsPerRow + (x >> 6)];
+    uint64_t mask = (uint64_t)1 << (x & 63);
+    if (occupied) word |= mask;
+    else word &= ~mask;
+}
+
+bool OccupancyBitmap::CastRay(Vector2 origin, float angle, float range, float& hitDistance, int* steps) const {
+    const float inf = std::numeric_limits<float>::infinity();
+    float dx = cosf(angle);
+    float dy = -sinf(angle);
+
+    int ix = (int)floorf(origin.x);
+    int iy = (int)floorf(origin.y);
+    int count = 1;
+    if (steps) *steps = count;
+    if (IsOccupied(ix, iy)) { hitDistance = 0.0f; return true; }
+
+    int stepX = (dx > 0.0f) ? 1 : -1;
+    int stepY = (dy > 0.0f) ? 1 : -1;
+    float tDeltaX = (dx != 0.0f) ? fabsf(1.0f / dx) : inf;
+    float tDeltaY = (dy != 0.0f) ? fabsf(1.0f / dy) : inf;
+
+    // Distance along the ray to the first vertical / horizontal cell boundary
+    float tMaxX = (dx > 0.0f) ? (ix + 1 - origin.x) * tDeltaX
+                : (dx < 0.0f) ? (origin.x - ix) * tDeltaX : inf;
+    float tMaxY = (dy > 0.0f) ? (iy + 1 - origin.y) * tDeltaY
+                : (dy < 0.0f) ? (origin.y - iy) * tDeltaY : inf;
+
+    for (;;) {
+        float t;
+        if (tMaxX < tMaxY) {
+            ix += stepX;
+            t = tMaxX;
+            tMaxX += tDeltaX;
+        } else {
+            iy += stepY;
+            t = tMaxY;
+            tMaxY += tDeltaY;
+        }
+        if (steps) *steps = ++count;
+        if (t > range) return false;
+
+        // Left the map and moving further away: nothing more to hit
+        if ((ix < 0 && stepX < 0) || (ix >= width && stepX > 0) ||
+            (iy < 0 && stepY < 0) || (iy >= height && stepY > 0))
+            return false;
+
+        if (IsOccupied(ix, iy)) {
+            hitDistance = t;
+            return true;
+        }
+    }
+}
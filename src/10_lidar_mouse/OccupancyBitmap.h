@@ -0,0 +1,36 @@
+#pragma once
+#include <raylib.h>
+#include <cstdint>
+#include <vector>
+
+// 1 bit per map pixel: set = wall.
+// Built once from the floor plan so ray casts never touch the Image.
+class OccupancyBitmap {
+public:
+    OccupancyBitmap() = default;
+    OccupancyBitmap(int width, int height);
+    explicit OccupancyBitmap(const Image& map);   // black pixels are walls
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+
+    // Out-of-bounds cells count as free space
+    bool IsOccupied(int x, int y) const {
+        if ((unsigned)x >= (unsigned)width || (unsigned)y >= (unsigned)height) return false;
+        return (bits[y * wordsPerRow + (x >> 6)] >> (x & 63)) & 1;
+    }
+
+    void Set(int x, int y, bool occupied);
+
+    // Amanatides-Woo grid traversal: visits exactly the cells the ray
+    // crosses and returns the distance at which it enters the first wall
+    // cell. Angle follows the screen convention (y grows downwards, so
+    // the direction is (cos a, -sin a)). steps (optional) receives the
+    // number of cells visited.
+    bool CastRay(Vector2 origin, float angle, float range, float& hitDistance, int* steps = nullptr) const;
+
+private:
+    int width = 0, height = 0;
+    int wordsPerRow = 0;
+    std::vector<uint64_t> bits;
+};
@@ -0,0 +1,182 @@
+#include "ParticleFilter.h"
+#include "DistanceField.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+static double MillisSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+LikelihoodField::LikelihoodField(const DistanceField& field, float sigma, float zHit, float zRand)
+    : width(field.Width()), height(field.Height()), logLikelihood((size_t)field.Width() * field.Height()) {
+    const float norm = 1.0f / (sqrtf(2.0f * PI) * sigma);
+    outside = logf(zRand * norm);
+    for (int yy = 0; yy < height; yy++) {
+        for (int xx = 0; xx < width; xx++) {
+            float d = field.At(xx, yy);
+            float p = zHit * norm * expf(-d * d / (2.0f * sigma * sigma)) + zRand * norm;
+            logLikelihood[yy * width + xx] = logf(p);
+        }
+    }
+}
+
+void ParticleFilter::Init(int count, const DistanceField& field, unsigned seed, float headingSpread) {
+    likelihood = LikelihoodField(field);
+    gen.seed(seed);
+    workerGen.clear();
+
+    x.resize(count); y.resize(count); theta.resize(count);
+    logWeight.assign(count, 0.0f);
+    weight.assign(count, 1.0f / count);
+
+    // Uniform over free space
+    std::uniform_real_distribution<float> rx(0, field.Width()), ry(0, field.Height());
+    std::uniform_real_distribution<float> rt(-headingSpread, headingSpread);
+    for (int i = 0; i < count; i++) {
+        do { x[i] = rx(gen); y[i] = ry(gen); } while (field.At((int)x[i], (int)y[i]) < 1.0f);
+        theta[i] = rt(gen);
+    }
+}
+
+void ParticleFilter::Predict(Vector2 motion, ThreadPool& pool) {
+    if ((int)workerGen.size() < pool.Size()) {
+        int first = (int)workerGen.size();
+        workerGen.resize(pool.Size());
+        for (int w = first; w < pool.Size(); w++) workerGen[w].seed(gen());
+    }
+
+    float moved = sqrtf(motion.x * motion.x + motion.y * motion.y);
+    float sigma = motionNoise + 0.05f * moved;
+    pool.ParallelFor(Size(), [&](int begin, int end, int w) {
+        std::normal_distribution<float> pos(0.0f, sigma), head(0.0f, headingNoise);
+        std::mt19937& g = workerGen[w];
+        for (int i = begin; i < end; i++) {
+            // Odometry is in the robot frame: rotate it by the particle's
+            // heading (screen convention, forward is (cos t, -sin t))
+            float c = cosf(theta[i]), s = sinf(theta[i]);
+            x[i] += motion.x * c + motion.y * s + pos(g);
+            y[i] += -motion.x * s + motion.y * c + pos(g);
+            theta[i] += head(g);
+        }
+    });
+}
+
+void ParticleFilter::Weigh(const std::vector<SensorMeasurement>& scan, ThreadPool& pool) {
+    // Subsample the scan and precompute each beam's direction once
+    int n = (int)scan.size();
+    int stride = std::max(1, (n + maxBeams - 1) / maxBeams);
+    beamRange.clear(); beamCos.clear(); beamSin.clear();
+    for (int k = 0; k < n; k += stride) {
+        beamRange.push_back(scan[k].distance);
+        beamCos.push_back(cosf(scan[k].angle));
+        beamSin.push_back(sinf(scan[k].angle));
+    }
+    const int beams = (int)beamRange.size();
+    const float* r = beamRange.data();
+    const float* bc = beamCos.data();
+    const float* bs = beamSin.data();
+
+    pool.ParallelFor(Size(), [&](int begin, int end, int) {
+        for (int i = begin; i < end; i++) {
+            const float px = x[i], py = y[i];
+            const float c = cosf(theta[i]), s = sinf(theta[i]);
+            float sum = 0.0f;
+            for (int k = 0; k < beams; k++) {
+                // Beam angle rotated by the heading; screen y grows downwards
+                float dc = bc[k] * c - bs[k] * s;
+                float ds = bs[k] * c + bc[k] * s;
+                int ex = (int)floorf(px + r[k] * dc);
+                int ey = (int)floorf(py - r[k] * ds);
+                sum += likelihood.At(ex, ey);
+            }
+            logWeight[i] = sum;
+        }
+    });
+}
+
+void ParticleFilter::Normalise() {
+    int n = Size();
+    float best = *std::max_element(logWeight.begin(), logWeight.end());
+    double total = 0.0;
+    for (int i = 0; i < n; i++) {
+        // Weights carry over between updates until the next resample
+        weight[i] *= expf((logWeight[i] - best) * temper);
+        total += weight[i];
+    }
+    if (total <= 0.0) { std::fill(weight.begin(), weight.end(), 1.0f / n); return; }
+    float inv = (float)(1.0 / total);
+    for (int i = 0; i < n; i++) weight[i] *= inv;
+}
+
+// Low-variance (systematic) resampling: one random offset, N evenly
+// spaced pointers into the cumulative weights, O(N)
+void ParticleFilter::Resample() {
+    int n = Size();
+    nx.resize(n); ny.resize(n); ntheta.resize(n);
+    std::uniform_real_distribution<float> u(0.0f, 1.0f / n);
+    float pointer = u(gen);
+    float cumulative = weight[0];
+    int j = 0;
+    for (int i = 0; i < n; i++) {
+        float target = pointer + (float)i / n;
+        while (target > cumulative && j < n - 1) cumulative += weight[++j];
+        nx[i] = x[j]; ny[i] = y[j]; ntheta[i] = theta[j];
+    }
+    x.swap(nx); y.swap(ny); theta.swap(ntheta);
+    std::fill(weight.begin(), weight.end(), 1.0f / n);
+}
+
+void ParticleFilter::Step(Vector2 motion, const std::vector<SensorMeasurement>& scan, ThreadPool& pool) {
+    timings = MclTimings();
+    if (Size() == 0) return;
+
+    auto start = std::chrono::steady_clock::now();
+    Predict(motion, pool);
+    timings.predict = MillisSince(start);
+    if (scan.empty()) return;
+
+    start = std::chrono::steady_clock::now();
+    Weigh(scan, pool);
+    timings.weight = MillisSince(start);
+
+    start = std::chrono::steady_clock::now();
+    Normalise();
+    timings.normalise = MillisSince(start);
+
+    start = std::chrono::steady_clock::now();
+    if (EffectiveSampleSize() < 0.5f * Size()) Resample();
+    timings.resample = MillisSince(start);
+}
+
+float ParticleFilter::EffectiveSampleSize() const {
+    double sum2 = 0.0;
+    for (float w : weight) sum2 += (double)w * w;
+    return sum2 > 0.0 ? (float)(1.0 / sum2) : 0.0f;
+}
+
+Vector2 ParticleFilter::Estimate(float* heading, float* spread) const {
+    double mx = 0.0, my = 0.0, mc = 0.0, ms = 0.0;
+    for (int i = 0; i < Size(); i++) {
+        mx += weight[i] * x[i];
+        my += weight[i] * y[i];
+        mc += weight[i] * cosf(theta[i]);
+        ms += weight[i] * sinf(theta[i]);
+    }
+    if (heading) *heading = (float)atan2(ms, mc);
+    if (spread) {
+        double var = 0.0;
+        for (int i = 0; i < Size(); i++)
+            var += weight[i] * ((x[i] - mx) * (x[i] - mx) + (y[i] - my) * (y[i] - my));
+        *spread = (float)sqrt(var);
+    }
+    return {(float)mx, (float)my};
+}
+
+void ParticleFilter::Draw() const {
+    // Draw a capped subset; thousands of pixels are enough to see the cloud
+    int step = std::max(1, Size() / 5000);
+    for (int i = 0; i < Size(); i += step)
+        DrawPixelV({x[i], y[i]}, ORANGE);
+}
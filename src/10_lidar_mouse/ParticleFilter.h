@@ -0,0 +1,79 @@
+#pragma once
+#include <raylib.h>
+#include <random>
+#include <vector>
+#include "SensorMeasurement.h"
+
+class DistanceField;
+class ThreadPool;
+
+// Per-beam log likelihood of a return ending in each map cell, from the
+// distance to the nearest wall: log(zHit * N(d; 0, sigma) + zRand).
+// Built once from the distance field, so weighting a beam is one lookup.
+class LikelihoodField {
+public:
+    LikelihoodField() = default;
+    LikelihoodField(const DistanceField& field, float sigma = 3.0f, float zHit = 0.9f, float zRand = 0.1f);
+
+    float At(int x, int y) const {
+        if ((unsigned)x >= (unsigned)width || (unsigned)y >= (unsigned)height) return outside;
+        return logLikelihood[y * width + x];
+    }
+
+private:
+    int width = 0, height = 0;
+    float outside = 0.0f;   // off-map returns only fit the random model
+    std::vector<float> logLikelihood;
+};
+
+// Time spent in each stage of the last Step(), in milliseconds
+struct MclTimings {
+    double predict = 0.0, weight = 0.0, normalise = 0.0, resample = 0.0;
+    double Total() const { return predict + weight + normalise + resample; }
+};
+
+// Monte Carlo localisation: particles (x, y, heading) in SoA arrays.
+// Measurement angles are in the sensor frame; the mouse-driven sensor
+// has heading 0, so the true pose has theta = 0.
+class ParticleFilter {
+public:
+    float motionNoise = 1.0f;      // px per step, plus 5% of the distance moved
+    float headingNoise = 0.01f;    // rad per step
+    float temper = 0.05f;          // flattens weights: neighbouring beams are not independent
+    int maxBeams = 360;            // scans are subsampled to at most this many beams
+
+    MclTimings timings;
+
+    // Spread particles uniformly over free space with headings in
+    // [-headingSpread, headingSpread]. The mouse sensor reports angles in
+    // the map frame, so by default only the position is unknown; pass PI
+    // for a fully unknown heading (needs far more particles).
+    void Init(int count, const DistanceField& field, unsigned seed = 1, float headingSpread = 0.05f);
+    int Size() const { return (int)x.size(); }
+
+    // Odometry step (motion in the robot frame) followed by a scan update.
+    // Resamples when the effective sample size drops below half.
+    void Step(Vector2 motion, const std::vector<SensorMeasurement>& scan, ThreadPool& pool);
+
+    // Weighted mean pose and its spread (px)
+    Vector2 Estimate(float* heading = nullptr, float* spread = nullptr) const;
+    float EffectiveSampleSize() const;
+
+    void Draw() const;
+
+    const LikelihoodField& Likelihood() const { return likelihood; }
+
+private:
+    std::vector<float> x, y, theta;
+    std::vector<float> logWeight, weight;
+    std::vector<float> nx, ny, ntheta;       // resampling scratch
+    std::vector<float> beamRange, beamCos, beamSin;
+    std::vector<std::mt19937> workerGen;
+    std::mt19937 gen;
+    LikelihoodField likelihood;
+
+    void Predict(Vector2 motion, ThreadPool& pool);
+    void Weigh(const std::vector<SensorMeasurement>& scan, ThreadPool& pool);
+    void Normalise();
+    void Resample();
+};
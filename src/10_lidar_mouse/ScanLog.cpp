@@ -0,0 +1,109 @@
+#include "ScanLog.h"
+#include <cstdint>
+#include <cstring>
+
+static const char MAGIC[4] = {'L', 'S', 'C', 'N'};
+static const uint32_t VERSION = 1;
+static const size_t FLUSH_SIZE = 1 << 20;
+
+bool ScanLogWriter::Open(const char* filename, const char* mapFile) {
+    Close();
+    file = fopen(filename, "wb");
+    if (!file) return false;
+
+    buffer.clear();
+    buffer.reserve(FLUSH_SIZE + 4096);
+    frames = 0;
+    bytes = 0;
+
+    uint32_t pathLength = (uint32_t)strlen(mapFile);
+    Append(MAGIC, 4);
+    Append(&VERSION, 4);
+    Append(&pathLength, 4);
+    Append(mapFile, pathLength);
+    return true;
+}
+
+void ScanLogWriter::Append(const void* src, size_t size) {
+    const char* p = (const char*)src;
+    buffer.insert(buffer.end(), p, p + size);
+    bytes += size;
+}
+
+void ScanLogWriter::Flush() {
+    if (file && !buffer.empty()) fwrite(buffer.data(), 1, buffer.size(), file);
+    buffer.clear();
+}
+
+void ScanLogWriter::WriteFrame(double timestamp, Vector2 pose, const std::vector<SensorMeasurement>& scan) {
+    if (!file) return;
+    uint32_t count = (uint32_t)scan.size();
+    Append(&timestamp, 8);
+    Append(&pose.x, 4);
+    Append(&pose.y, 4);
+    Append(&count, 4);
+
+    // Write the ray pairs straight into the buffer (frames are not aligned)
+    size_t at = buffer.size();
+    buffer.resize(at + count * 8);
+    char* out = buffer.data() + at;
+    for (uint32_t i = 0; i < count; i++) {
+        memcpy(out + 8 * i, &scan[i].distance, 4);
+        memcpy(out + 8 * i + 4, &scan[i].angle, 4);
+    }
+    bytes += count * 8;
+
+    frames++;
+    if (buffer.size() >= FLUSH_SIZE) Flush();
+}
+
+void ScanLogWriter::Close() {
+    if (!file) return;
+    Flush();
+    fclose(file);
+    file = nullptr;
+}
+
+bool ScanLogReader::Open(const char* filename) {
+    data.clear();
+    FILE* f = fopen(filename, "rb");
+    if (!f) return false;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    data.resize(size > 0 ? size : 0);
+    size_t got = fread(data.data(), 1, data.size(), f);
+    fclose(f);
+    if (got != data.size() || data.size() < 12 || memcmp(data.data(), MAGIC, 4) != 0) return false;
+
+    uint32_t version, pathLength;
+    memcpy(&version, &data[4], 4);
+    memcpy(&pathLength, &data[8], 4);
+    if (version != VERSION || 12 + (size_t)pathLength > data.size()) return false;
+
+    mapFile.assign(&data[12], pathLength);
+    headerSize = 12 + pathLength;
+    cursor = headerSize;
+    return true;
+}
+
+bool ScanLogReader::ReadFrame(double& timestamp, Vector2& pose, std::vector<SensorMeasurement>& scan) {
+    if (cursor + 20 > data.size()) return false;
+    const char* p = &data[cursor];
+    uint32_t count;
+    memcpy(&timestamp, p, 8);
+    memcpy(&pose.x, p + 8, 4);
+    memcpy(&pose.y, p + 12, 4);
+    memcpy(&count, p + 16, 4);
+    if (cursor + 20 + (size_t)count * 8 > data.size()) return false;
+
+    scan.resize(count);
+    const char* rays = p + 20;
+    for (uint32_t i = 0; i < count; i++) {
+        memcpy(&scan[i].distance, rays + 8 * i, 4);
+        memcpy(&scan[i].angle, rays + 8 * i + 4, 4);
+        scan[i].position = pose;
+    }
+    cursor += 20 + (size_t)count * 8;
+    return true;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <raylib.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "SensorMeasurement.h"
+
+// Binary log of LIDAR scans in the writer's native byte order, so logs
+// only replay on a machine of the same endianness:
+//   header: "LSCN", uint32 version, uint32 map path length, map path bytes
+//   frame:  double timestamp, float pose x, float pose y, uint32 count,
+//           count x (float distance, float angle)
+// Every measurement of a frame shares the frame's pose.
+
+class ScanLogWriter {
+public:
+    ~ScanLogWriter() { Close(); }
+
+    bool Open(const char* filename, const char* mapFile);
+    void WriteFrame(double timestamp, Vector2 pose, const std::vector<SensorMeasurement>& scan);
+    void Close();
+
+    bool IsOpen() const { return file != nullptr; }
+    int Frames() const { return frames; }
+    size_t Bytes() const { return bytes; }
+
+private:
+    FILE* file = nullptr;
+    std::vector<char> buffer;   // frames are batched here and flushed in large writes
+    int frames = 0;
+    size_t bytes = 0;
+
+    void Append(const void* data, size_t size);
+    void Flush();
+};
+
+// Loads the whole log into memory and hands out frames in order
+class ScanLogReader {
+public:
+    bool Open(const char* filename);
+
+    const std::string& MapFile() const { return mapFile; }
+    size_t Bytes() const { return data.size(); }
+
+    // Returns false at the end of the log (or on a truncated frame)
+    bool ReadFrame(double& timestamp, Vector2& pose, std::vector<SensorMeasurement>& scan);
+    void Rewind() { cursor = headerSize; }
+
+private:
+    std::vector<char> data;
+    std::string mapFile;
+    size_t headerSize = 0;
+    size_t cursor = 0;
+};
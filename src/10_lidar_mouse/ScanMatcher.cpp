@@ -0,0 +1,228 @@
+#include "ScanMatcher.h"
+#include <algorithm>
+#include <cmath>
+
+// ------------------ KdTree2D ------------------
+void KdTree2D::Build(std::vector<Vector2> pts) {
+    points.swap(pts);
+    BuildRange(0, (int)points.size(), 0);
+}
+
+void KdTree2D::BuildRange(int lo, int hi, int depth) {
+    if (hi - lo <= 1) return;
+    int mid = (lo + hi) / 2;
+    if (depth % 2 == 0)
+        std::nth_element(points.begin() + lo, points.begin() + mid, points.begin() + hi,
+                         [](Vector2 a, Vector2 b) { return a.x < b.x; });
+    else
+        std::nth_element(points.begin() + lo, points.begin() + mid, points.begin() + hi,
+                         [](Vector2 a, Vector2 b) { return a.y < b.y; });
+    BuildRange(lo, mid, depth + 1);
+    BuildRange(mid + 1, hi, depth + 1);
+}
+
+void KdTree2D::Search(int lo, int hi, int depth, Vector2 q, float& bestD2, int& bestIndex) const {
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        Vector2 p = points[mid];
+        float dx = p.x - q.x, dy = p.y - q.y;
+        float d2 = dx * dx + dy * dy;
+        if (d2 < bestD2) { bestD2 = d2; bestIndex = mid; }
+
+        // Near side first, so bestD2 is as tight as it gets before the far
+        // side is tested against the splitting line
+        float diff = (depth % 2 == 0) ? q.x - p.x : q.y - p.y;
+        int nearLo = diff < 0 ? lo : mid + 1, nearHi = diff < 0 ? mid : hi;
+        int farLo = diff < 0 ? mid + 1 : lo, farHi = diff < 0 ? hi : mid;
+        Search(nearLo, nearHi, depth + 1, q, bestD2, bestIndex);
+        if (diff * diff >= bestD2) return;
+        lo = farLo; hi = farHi;
+        depth++;
+    }
+}
+
+bool KdTree2D::Nearest(Vector2 q, float& bestD2, Vector2& best) const {
+    int index = -1;
+    Search(0, (int)points.size(), 0, q, bestD2, index);
+    if (index >= 0) best = points[index];
+    return index >= 0;
+}
+
+// ------------------ KdForest ------------------
+void KdForest::Insert(Vector2 p) {
+    pending.push_back(p);
+    if ((int)pending.size() >= baseSize) Carry();
+}
+
+void KdForest::Carry() {
+    // Like binary addition: gather occupied levels until the first empty one
+    std::vector<Vector2> merged;
+    merged.swap(pending);
+    size_t k = 0;
+    for (; k < levels.size() && levels[k].Size() > 0; k++) {
+        const std::vector<Vector2>& pts = levels[k].Points();
+        merged.insert(merged.end(), pts.begin(), pts.end());
+        levels[k] = KdTree2D();
+    }
+    if (k == levels.size()) levels.emplace_back();
+    levels[k].Build(std::move(merged));
+}
+
+void KdForest::Clear() {
+    pending.clear();
+    levels.clear();
+}
+
+int KdForest::Size() const {
+    int n = (int)pending.size();
+    for (auto& t : levels) n += t.Size();
+    return n;
+}
+
+std::vector<Vector2> KdForest::Points() const {
+    std::vector<Vector2> all(pending);
+    for (auto& t : levels) all.insert(all.end(), t.Points().begin(), t.Points().end());
+    return all;
+}
+
+int KdForest::Levels() const {
+    int n = 0;
+    for (auto& t : levels) if (t.Size() > 0) n++;
+    return n;
+}
+
+bool KdForest::Nearest(Vector2 q, float maxDist, Vector2& best) const {
+    float bestD2 = maxDist * maxDist;
+    bool found = false;
+    for (auto& t : levels)
+        if (t.Size() > 0 && t.Nearest(q, bestD2, best)) found = true;
+    for (Vector2 p : pending) {
+        float dx = p.x - q.x, dy = p.y - q.y;
+        float d2 = dx * dx + dy * dy;
+        if (d2 < bestD2) { bestD2 = d2; best = p; found = true; }
+    }
+    return found;
+}
+
+bool NearestBruteForce(const std::vector<Vector2>& points, Vector2 q, float maxDist, Vector2& best) {
+    float bestD2 = maxDist * maxDist;
+    bool found = false;
+    for (Vector2 p : points) {
+        float dx = p.x - q.x, dy = p.y - q.y;
+        float d2 = dx * dx + dy * dy;
+        if (d2 < bestD2) { bestD2 = d2; best = p; found = true; }
+    }
+    return found;
+}
+
+// ------------------ ICP ------------------
+Vector2 Pose2D::Apply(Vector2 p) const {
+    float c = cosf(theta), s = sinf(theta);
+    return {c * p.x - s * p.y + x, s * p.x + c * p.y + y};
+}
+
+// Unit normals of a scan from its neighbours in ray order; points whose
+// neighbours are too far apart (a depth jump) get no normal and are not
+// used for matching. "Too far" scales with the ray spacing: neighbours on
+// one wall at range r, seen across an angle a, are about r * a apart, so
+// sparse scans keep their normals too.
+static void ScanNormals(const std::vector<Vector2>& scan, std::vector<Vector2>& normals, std::vector<char>& valid) {
+    int n = (int)scan.size();
+    normals.assign(n, {0.0f, 0.0f});
+    valid.assign(n, 0);
+    for (int i = 1; i + 1 < n; i++) {
+        Vector2 a = scan[i - 1], b = scan[i + 1];
+        float tx = b.x - a.x;
+        float ty = b.y - a.y;
+        float len = sqrtf(tx * tx + ty * ty);
+        float range = sqrtf(scan[i].x * scan[i].x + scan[i].y * scan[i].y);
+        float span = fabsf(atan2f(a.x * b.y - a.y * b.x, a.x * b.x + a.y * b.y));
+        // Twice the spacing allows walls up to 60 degrees off square-on
+        float maxLen = std::max(12.0f, 2.0f * range * span);
+        if (len < 1e-3f || len > maxLen) continue;
+        normals[i] = {-ty / len, tx / len};
+        valid[i] = 1;
+    }
+}
+
+// Point-to-line ICP: each iteration linearises the rotation and solves the
+// 3x3 least-squares system for the increment (dx, dy, dtheta) minimising
+// the distances from scan points to the lines through their matches.
+template <typename NearestFn>
+static IcpResult Align(const std::vector<Vector2>& scan, Pose2D pose, const IcpOptions& opt, NearestFn nearest) {
+    std::vector<Vector2> normals;
+    std::vector<char> valid;
+    ScanNormals(scan, normals, valid);
+
+    IcpResult result;
+    float matchDistance = opt.maxMatchDistance;
+    for (int it = 0; it < opt.maxIterations; it++) {
+        result.iterations = it + 1;
+        float c = cosf(pose.theta), s = sinf(pose.theta);
+
+        // Normal equations A * [dx dy dtheta] = b, rotation about the pose
+        double A[3][3] = {{0}}, b[3] = {0}, err = 0.0;
+        int n = 0;
+        for (size_t i = 0; i < scan.size(); i++) {
+            if (!valid[i]) continue;
+            Vector2 p = pose.Apply(scan[i]), q = {0.0f, 0.0f};
+            if (!nearest(p, matchDistance, q)) continue;
+
+            float nx = c * normals[i].x - s * normals[i].y;
+            float ny = s * normals[i].x + c * normals[i].y;
+            double rx = p.x - pose.x, ry = p.y - pose.y;          // lever arm
+            double J[3] = {nx, ny, -ry * nx + rx * ny};
+            double r = (p.x - q.x) * nx + (p.y - q.y) * ny;
+            for (int a = 0; a < 3; a++) {
+                for (int k = 0; k < 3; k++) A[a][k] += J[a] * J[k];
+                b[a] -= J[a] * r;
+            }
+            err += r * r;
+            n++;
+        }
+        result.matched = n;
+        result.rms = n ? (float)sqrt(err / n) : 0.0f;
+        if (n < 3) break;
+
+        // Solve by Cramer's rule; a singular system means a degenerate scan
+        double det = A[0][0] * (A[1][1] * A[2][2] - A[1][2] * A[2][1])
+                   - A[0][1] * (A[1][0] * A[2][2] - A[1][2] * A[2][0])
+                   + A[0][2] * (A[1][0] * A[2][1] - A[1][1] * A[2][0]);
+        if (fabs(det) < 1e-9) break;
+        double x[3];
+        for (int col = 0; col < 3; col++) {
+            double M[3][3];
+            for (int a = 0; a < 3; a++)
+                for (int k = 0; k < 3; k++) M[a][k] = (k == col) ? b[a] : A[a][k];
+            x[col] = (M[0][0] * (M[1][1] * M[2][2] - M[1][2] * M[2][1])
+                    - M[0][1] * (M[1][0] * M[2][2] - M[1][2] * M[2][0])
+                    + M[0][2] * (M[1][0] * M[2][1] - M[1][1] * M[2][0])) / det;
+        }
+
+        pose.x += (float)x[0];
+        pose.y += (float)x[1];
+        pose.theta += (float)x[2];
+
+        // Tighten the gate as the estimate settles
+        matchDistance = std::max(opt.minMatchDistance, matchDistance * 0.8f);
+
+        if (fabs(x[2]) < opt.rotationEpsilon && hypot(x[0], x[1]) < opt.translationEpsilon) {
+            result.converged = true;
+            break;
+        }
+    }
+    result.pose = pose;
+    return result;
+}
+
+IcpResult AlignScan(const std::vector<Vector2>& scan, const KdForest& map, Pose2D guess, const IcpOptions& options) {
+    return Align(scan, guess, options, [&](Vector2 p, float maxDist, Vector2& q) {
+        return map.Nearest(p, maxDist, q);
+    });
+}
+
+IcpResult AlignScanBruteForce(const std::vector<Vector2>& scan, const std::vector<Vector2>& map, Pose2D guess, const IcpOptions& options) {
+    return Align(scan, guess, options, [&](Vector2 p, float maxDist, Vector2& q) {
+        return NearestBruteForce(map, p, maxDist, q);
+    });
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <raylib.h>
+#include <vector>
+
+// Static 2D k-d tree stored implicitly: the points array is reordered so
+// that every subrange [lo, hi) is a node split at its middle element,
+// alternating x and y with depth. No child pointers.
+class KdTree2D {
+public:
+    void Build(std::vector<Vector2> pts);
+    int Size() const { return (int)points.size(); }
+    const std::vector<Vector2>& Points() const { return points; }
+
+    // Nearest point with squared distance below bestD2 (updated in place)
+    bool Nearest(Vector2 q, float& bestD2, Vector2& best) const;
+
+private:
+    std::vector<Vector2> points;
+    void BuildRange(int lo, int hi, int depth);
+    void Search(int lo, int hi, int depth, Vector2 q, float& bestD2, int& bestIndex) const;
+};
+
+// Dynamic nearest-neighbour index from static trees (Bentley-Saxe
+// logarithmic method): level k is either empty or one tree of
+// baseSize * 2^k points. New points wait in a small linear buffer; when
+// it fills, it is merged with the occupied low levels into the first
+// empty one, so each point is rebuilt O(log n) times overall.
+class KdForest {
+public:
+    int baseSize = 64;
+
+    void Insert(Vector2 p);
+    void Clear();
+    int Size() const;
+    int Levels() const;
+    std::vector<Vector2> Points() const;
+
+    bool Nearest(Vector2 q, float maxDist, Vector2& best) const;
+
+private:
+    std::vector<Vector2> pending;
+    std::vector<KdTree2D> levels;
+    void Carry();
+};
+
+// Rigid 2D transform: world = R(theta) * local + (x, y)
+struct Pose2D {
+    float x = 0.0f, y = 0.0f, theta = 0.0f;
+    Vector2 Apply(Vector2 p) const;
+};
+
+struct IcpResult {
+    Pose2D pose;
+    int iterations = 0;
+    int matched = 0;          // correspondences in the last iteration
+    float rms = 0.0f;         // residual of those correspondences
+    bool converged = false;
+};
+
+// Point-to-line ICP. scan is in the sensor frame and in ray order (line
+// normals come from neighbouring points); guess is the initial sensor
+// pose. Matches outside the gate are dropped; the gate starts at
+// maxMatchDistance and shrinks each iteration. Both entry points share
+// one templated loop, only the nearest-neighbour search differs.
+struct IcpOptions {
+    int maxIterations = 30;
+    float maxMatchDistance = 20.0f;     // gate of the first iteration
+    float minMatchDistance = 3.0f;      // the gate shrinks to this
+    float translationEpsilon = 0.01f;   // px
+    float rotationEpsilon = 1e-4f;      // rad
+};
+
+IcpResult AlignScan(const std::vector<Vector2>& scan, const KdForest& map, Pose2D guess, const IcpOptions& options = IcpOptions());
+IcpResult AlignScanBruteForce(const std::vector<Vector2>& scan, const std::vector<Vector2>& map, Pose2D guess, const IcpOptions& options = IcpOptions());
+
+// Linear scan reference for the nearest-neighbour benchmark
+bool NearestBruteForce(const std::vector<Vector2>& points, Vector2 q, float maxDist, Vector2& best);
@@ -0,0 +1,9 @@
+#pragma once
+#include <raylib.h>
+
+// ------------------ Sensor Measurement ------------------
+struct SensorMeasurement {
+    float distance;   // measured distance
+    float angle;      // measured angle
+    Vector2 position; // sensor position
+};
@@ -1,14 +1,20 @@
 #include <raylib.h>
+#include <algorithm>
 #include <cmath>
 #include <vector>
 #include <random>
-
-// ------------------ Sensor Measurement ------------------
-struct SensorMeasurement {
-    float distance;   // measured distance
-    float angle;      // measured angle
-    Vector2 position; // sensor position
-};
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include "SensorMeasurement.h"
+#include "ScanLog.h"
+#include "OccupancyBitmap.h"
+#include "DistanceField.h"
+#include "HitGrid.h"
+#include "DirtyTiles.h"
+#include "ThreadPool.h"
+#include "ParticleFilter.h"
+#include "ScanMatcher.h"
 
 // ------------------ Laser Sensor ------------------
 class LaserSensor {
@@ -36,11 +42,95 @@ public:
         return sqrt(dx*dx + dy*dy);
     }
 
-    // Sense obstacles on the map image
-    std::vector<SensorMeasurement> senseObstacles(Image &map) {
+    int numRays = 60;          // number of laser rays
+
+    // Per-worker state for the parallel scan: own RNG and noise buffers
+    struct ScanWorker {
+        std::mt19937 gen;
+        std::vector<float> distNoise, angleNoise;
+    };
+    std::vector<ScanWorker> workers;
+    std::vector<int> chunkHits;       // measurements written by each chunk
+    std::vector<int> chunkBegin;      // first output slot of each chunk
+
+    // Sense obstacles with an exact grid traversal of the occupancy bitmap,
+    // or by sphere-tracing the distance field when one is given
+    std::vector<SensorMeasurement> senseObstacles(const OccupancyBitmap &map, const DistanceField* field = nullptr) {
+        std::vector<SensorMeasurement> data;
+
+        for(int i=0; i<numRays; i++) {
+            float angle = (2*M_PI) * i / numRays;
+
+            float hit;
+            bool found = field ? field->CastRay(position, angle, Range, hit)
+                               : map.CastRay(position, angle, Range, hit);
+            if (found) {
+                SensorMeasurement m;
+                m.distance = hit + dist_noise(gen);               // add noise
+                m.angle = fmod(angle + angle_noise(gen), 2*M_PI); // add angle noise
+                m.position = position;
+                data.push_back(m);
+            }
+        }
+        return data;
+    }
+
+    // Same scan split across a worker pool. Each chunk of rays writes into
+    // its own slice of the preallocated output, drawing its noise samples
+    // in one batch from the worker's RNG; the slices are then compacted.
+    // out keeps its capacity between calls, so steady state never allocates.
+    void senseObstaclesParallel(const OccupancyBitmap &map, const DistanceField* field,
+                                ThreadPool& pool, std::vector<SensorMeasurement>& out) {
+        if ((int)workers.size() < pool.Size()) {
+            int first = (int)workers.size();
+            workers.resize(pool.Size());
+            for (int w = first; w < pool.Size(); w++) workers[w].gen.seed(gen());
+        }
+        chunkHits.assign(pool.Size(), 0);
+        chunkBegin.assign(pool.Size(), 0);
+        out.resize(numRays);
+
+        pool.ParallelFor(numRays, [&](int begin, int end, int w) {
+            ScanWorker& sw = workers[w];
+            int n = end - begin;
+            sw.distNoise.resize(n);
+            sw.angleNoise.resize(n);
+            std::normal_distribution<float> dn(0, sigma_distance), an(0, sigma_angle);
+            for (int k = 0; k < n; k++) sw.distNoise[k] = dn(sw.gen);
+            for (int k = 0; k < n; k++) sw.angleNoise[k] = an(sw.gen);
+
+            int count = 0;
+            for (int i = begin; i < end; i++) {
+                float angle = (2*M_PI) * i / numRays;
+                float hit;
+                bool found = field ? field->CastRay(position, angle, Range, hit)
+                                   : map.CastRay(position, angle, Range, hit);
+                if (found) {
+                    SensorMeasurement& m = out[begin + count++];
+                    m.distance = hit + sw.distNoise[i - begin];
+                    m.angle = fmod(angle + sw.angleNoise[i - begin], 2*M_PI);
+                    m.position = position;
+                }
+            }
+            chunkBegin[w] = begin;
+            chunkHits[w] = count;
+        });
+
+        // Close the gaps between chunks (chunks are in ray order)
+        int total = 0;
+        for (int w = 0; w < pool.Size(); w++) {
+            if (chunkBegin[w] != total)
+                memmove(&out[total], &out[chunkBegin[w]], chunkHits[w] * sizeof(SensorMeasurement));
+            total += chunkHits[w];
+        }
+        out.resize(total);
+    }
+
+    // Original fixed-step sampler on the map image, kept as a reference.
+    // It can step straight over walls thinner than Range / stepsPerRay.
+    std::vector<SensorMeasurement> senseObstaclesFixedStep(Image &map) {
         std::vector<SensorMeasurement> data;
 
-        const int numRays = 60;    // number of laser rays
         const int stepsPerRay = 100; // samples along each ray
 
         for(int i=0; i<numRays; i++) {
@@ -85,14 +175,27 @@ public:
 class Environment {
 public:
     Image originalMapImage;     // the original floor plan
+    OccupancyBitmap occupancy;  // walls of the floor plan, 1 bit per pixel
+    DistanceField distanceField; // distance to the nearest wall, per pixel
     Image revealedMapImage;     // what sensor has seen
     Texture2D revealedMapTexture;
-    std::vector<Vector2> pointCloud; // scanned points
+    DirtyTiles revealedDirty;   // tiles of revealedMapImage changed this frame
+    HitGrid hits;               // scanned points, accumulated per pixel
+    KdForest mapPoints;         // one point per hit cell, for scan matching
+    int mapPointMinHits = 3;    // cells join mapPoints on this many hits (filters noise)
+
+    bool fullUploads = false;   // upload whole textures every frame (old behaviour)
+    size_t uploadedBytes = 0;   // bytes sent to the GPU by the last storeData
 
     Environment(const char* filename) {
         originalMapImage = LoadImage(filename); // load floor plan
+        ImageFormat(&originalMapImage, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8); // direct pixel reads
+        occupancy = OccupancyBitmap(originalMapImage);
+        distanceField = DistanceField(originalMapImage);
         revealedMapImage = GenImageColor(originalMapImage.width, originalMapImage.height, BLACK);
         revealedMapTexture = LoadTextureFromImage(revealedMapImage);
+        revealedDirty.Init(revealedMapImage.width, revealedMapImage.height);
+        hits.Init(originalMapImage.width, originalMapImage.height);
     }
 
     // Convert polar coordinates to Cartesian
@@ -101,58 +204,607 @@ public:
                  robotPos.y - distance * sin(angle) };
     }
 
-    // Store sensor data: update point cloud and reveal map
+    // Store sensor data: update hit grid and reveal map
     void storeData(std::vector<SensorMeasurement>& data) {
+        const Color* orig = (const Color*)originalMapImage.data;
+        Color* revealed = (Color*)revealedMapImage.data;
+
         for(auto& m : data) {
             Vector2 p = polarToCartesian(m.distance, m.angle, m.position);
-            pointCloud.push_back(p);
+            if (hits.AddHit(p) == mapPointMinHits) mapPoints.Insert({floorf(p.x) + 0.5f, floorf(p.y) + 0.5f});
 
             // reveal original map pixel at this point
             if (p.x >= 0 && p.x < revealedMapImage.width &&
                 p.y >= 0 && p.y < revealedMapImage.height) {
 
-                Color origColor = GetImageColor(originalMapImage, (int)p.x, (int)p.y);
-                ImageDrawPixel(&revealedMapImage, (int)p.x, (int)p.y, origColor);
+                int x = (int)p.x, y = (int)p.y;
+                int i = y * revealedMapImage.width + x;
+                if (memcmp(&revealed[i], &orig[i], sizeof(Color)) != 0) {
+                    revealed[i] = orig[i];
+                    revealedDirty.Mark(x, y);
+                }
             }
         }
-        UpdateTexture(revealedMapTexture, revealedMapImage.data);
+
+        // Upload only the tiles that changed
+        if (fullUploads) {
+            UpdateTexture(revealedMapTexture, revealedMapImage.data);
+            revealedDirty.Clear();
+            uploadedBytes = (size_t)revealedMapImage.width * revealedMapImage.height * sizeof(Color);
+        } else {
+            uploadedBytes = revealedDirty.Upload(revealedMapTexture, revealedMapImage);
+        }
+        uploadedBytes += hits.UploadTexture(fullUploads);
     }
 
-    // Draw scanned points (red)
+    // Draw scanned points (red), one texture for the whole grid
     void drawSensorData() {
-        for(auto& p : pointCloud) {
-            DrawPixelV(p, RED);
-        }
+        hits.Draw();
     }
 
     ~Environment() {
+        hits.Unload();
         UnloadTexture(revealedMapTexture);
         UnloadImage(originalMapImage);
         UnloadImage(revealedMapImage);
     }
 };
 
+// ------------------ Self test & benchmark ------------------
+// Ground truth for the self test: march in 0.01 px steps
+static bool CastRayFine(const OccupancyBitmap& map, Vector2 o, float angle, float range, float& hit) {
+    for (float t = 0.0f; t <= range; t += 0.01f) {
+        float x = o.x + t * cosf(angle);
+        float y = o.y - t * sinf(angle);
+        if (map.IsOccupied((int)floorf(x), (int)floorf(y))) { hit = t; return true; }
+    }
+    return false;
+}
+
+// 1-px walls: the fixed-step sampler (2 px per step at range 200) skips
+// some of them, the DDA must hit every one the fine reference hits.
+int RunSelfTest() {
+    const int w = 400, h = 400;
+    Image img = GenImageColor(w, h, WHITE);
+    for (int y = 0; y < h; y++) ImageDrawPixel(&img, 251, y, BLACK);       // vertical wall
+    for (int x = 0; x < w; x++) ImageDrawPixel(&img, x, 331, BLACK);       // horizontal wall
+    for (int i = 0; i < 150; i++) ImageDrawPixel(&img, 20 + i, 180 - i, BLACK); // diagonal wall
+    OccupancyBitmap map(img);
+
+    LaserSensor laser(200, 0.0f, 0.0f);
+    laser.position = {100.5f, 200.5f};
+
+    const int rays = 3600;
+    int expected = 0, ddaHits = 0, fixedHits = 0, ddaBadDistance = 0;
+    for (int i = 0; i < rays; i++) {
+        float angle = (2*M_PI) * i / rays;
+        float truth, hit;
+        bool hasTruth = CastRayFine(map, laser.position, angle, laser.Range, truth);
+        if (!hasTruth) continue;
+        expected++;
+
+        if (map.CastRay(laser.position, angle, laser.Range, hit)) {
+            ddaHits++;
+            if (fabsf(hit - truth) > 0.02f) ddaBadDistance++;
+        }
+
+        // Same sampling as senseObstaclesFixedStep, one ray
+        for (int j = 0; j < 100; j++) {
+            float u = j / 100.0f;
+            float x = laser.position.x + laser.Range * cosf(angle) * u;
+            float y = laser.position.y - laser.Range * sinf(angle) * u;
+            if (x >= 0 && x < w && y >= 0 && y < h && map.IsOccupied((int)x, (int)y)) {
+                fixedHits++;
+                break;
+            }
+        }
+    }
+    UnloadImage(img);
+
+    printf("rays crossing a 1-px wall: %d\n", expected);
+    printf("fixed-step hits:           %d (missed %d)\n", fixedHits, expected - fixedHits);
+    printf("DDA hits:                  %d (missed %d, %d with distance error > 0.02 px)\n",
+           ddaHits, expected - ddaHits, ddaBadDistance);
+
+    bool pass = ddaHits == expected && ddaBadDistance == 0 && fixedHits < expected;
+    printf("%s\n", pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
+
+// Rays per second and loop steps per ray: fixed-step vs DDA vs distance field
+int RunBenchmark(const char* mapFile) {
+    double start = GetTime();
+    Environment env(mapFile);
+    double loadMs = (GetTime() - start) * 1000.0;
+    LaserSensor laser(200, 0.5f, 0.01f);
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> rx(0, env.originalMapImage.width);
+    std::uniform_real_distribution<float> ry(0, env.originalMapImage.height);
+    std::vector<Vector2> poses;
+    while (poses.size() < 2000) {
+        Vector2 p = {rx(gen), ry(gen)};
+        if (!env.occupancy.IsOccupied((int)p.x, (int)p.y)) poses.push_back(p);
+    }
+    const double rays = (double)poses.size() * laser.numRays;
+
+    start = GetTime();
+    size_t fixedHits = 0;
+    for (auto& p : poses) { laser.position = p; fixedHits += laser.senseObstaclesFixedStep(env.originalMapImage).size(); }
+    double fixedRate = rays / (GetTime() - start);
+
+    start = GetTime();
+    size_t ddaHits = 0;
+    for (auto& p : poses) { laser.position = p; ddaHits += laser.senseObstacles(env.occupancy).size(); }
+    double ddaRate = rays / (GetTime() - start);
+
+    start = GetTime();
+    size_t fieldHits = 0;
+    for (auto& p : poses) { laser.position = p; fieldHits += laser.senseObstacles(env.occupancy, &env.distanceField).size(); }
+    double fieldRate = rays / (GetTime() - start);
+
+    // Average loop iterations per ray (the fixed sampler always plans 100)
+    long ddaSteps = 0, fieldSteps = 0;
+    for (auto& p : poses) {
+        for (int i = 0; i < laser.numRays; i++) {
+            float angle = (2*M_PI) * i / laser.numRays, hit;
+            int steps;
+            env.occupancy.CastRay(p, angle, laser.Range, hit, &steps);
+            ddaSteps += steps;
+            env.distanceField.CastRay(p, angle, laser.Range, hit, &steps);
+            fieldSteps += steps;
+        }
+    }
+
+    printf("%s, %zu scans x %d rays (load + bitmap + distance field: %.1f ms)\n",
+           mapFile, poses.size(), laser.numRays, loadMs);
+    printf("fixed-step:     %10.0f rays/s  (%zu hits, <=100 steps/ray)\n", fixedRate, fixedHits);
+    printf("DDA:            %10.0f rays/s  (%zu hits, %.1f steps/ray)\n", ddaRate, ddaHits, ddaSteps / rays);
+    printf("distance field: %10.0f rays/s  (%zu hits, %.1f steps/ray)\n", fieldRate, fieldHits, fieldSteps / rays);
+    return 0;
+}
+
+// Texture upload volume per frame: whole images vs dirty tiles.
+// The sensor follows the same Lissajous path over the map in both runs.
+int RunUploadBenchmark(const char* mapFile) {
+    const int frames = 1200;
+    printf("%s, %d frames\n", mapFile, frames);
+
+    for (int mode = 0; mode < 2; mode++) {
+        Environment env(mapFile);
+        env.fullUploads = (mode == 0);
+        LaserSensor laser(200, 0.5f, 0.01f);
+        laser.gen.seed(42);
+
+        const float w = (float)env.originalMapImage.width;
+        const float h = (float)env.originalMapImage.height;
+        size_t bytes = 0, maxBytes = 0;
+        double start = GetTime();
+        for (int f = 0; f < frames; f++) {
+            laser.position = { w * (0.5f + 0.45f * sinf(f * 0.013f)),
+                               h * (0.5f + 0.45f * sinf(f * 0.021f)) };
+            auto data = laser.senseObstacles(env.occupancy, &env.distanceField);
+            env.storeData(data);
+            bytes += env.uploadedBytes;
+            if (env.uploadedBytes > maxBytes) maxBytes = env.uploadedBytes;
+        }
+        double ms = (GetTime() - start) * 1000.0 / frames;
+
+        printf("%-12s %9.1f KB/frame avg, %9.1f KB max, %.3f ms/frame sense + store\n",
+               mode == 0 ? "full upload:" : "dirty tiles:",
+               bytes / 1024.0 / frames, maxBytes / 1024.0, ms);
+    }
+    return 0;
+}
+
+// Rays per frame sustainable at 60 FPS for the threaded scan, 1..N threads.
+// Times sensing alone and sensing plus storeData (which stays serial).
+int RunScanBenchmark(const char* mapFile, int maxThreads) {
+    Environment env(mapFile);
+    LaserSensor laser(200, 0.5f, 0.01f);
+    laser.numRays = 3600;   // 0.1 degree resolution
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> rx(0, env.originalMapImage.width);
+    std::uniform_real_distribution<float> ry(0, env.originalMapImage.height);
+    std::vector<Vector2> poses;
+    while (poses.size() < 500) {
+        Vector2 p = {rx(gen), ry(gen)};
+        if (!env.occupancy.IsOccupied((int)p.x, (int)p.y)) poses.push_back(p);
+    }
+    const double rays = (double)poses.size() * laser.numRays;
+
+    std::vector<int> threadCounts;
+    for (int t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    printf("%s, %zu scans x %d rays\n", mapFile, poses.size(), laser.numRays);
+    printf("threads  ms/scan  rays/frame@60  (with storeData)\n");
+    std::vector<SensorMeasurement> scan;
+    for (int t : threadCounts) {
+        ThreadPool pool(t);
+
+        double start = GetTime();
+        for (auto& p : poses) { laser.position = p; laser.senseObstaclesParallel(env.occupancy, &env.distanceField, pool, scan); }
+        double senseSec = GetTime() - start;
+
+        start = GetTime();
+        for (auto& p : poses) {
+            laser.position = p;
+            laser.senseObstaclesParallel(env.occupancy, &env.distanceField, pool, scan);
+            env.storeData(scan);
+        }
+        double totalSec = GetTime() - start;
+
+        printf("%7d  %7.3f  %13.0f  (%.0f)\n", t, senseSec * 1000.0 / poses.size(),
+               rays / senseSec / 60.0, rays / totalSec / 60.0);
+    }
+    return 0;
+}
+
+// Feed every frame of a scan log through storeData as fast as possible
+int RunReplay(const char* logFile) {
+    ScanLogReader log;
+    if (!log.Open(logFile)) { printf("cannot read scan log %s\n", logFile); return 1; }
+
+    InitWindow(1200, 600, "LIDAR replay");
+    Environment env(log.MapFile().c_str());
+
+    std::vector<SensorMeasurement> scan;
+    double timestamp;
+    Vector2 pose;
+    size_t frames = 0, rays = 0;
+    double start = GetTime();
+    while (log.ReadFrame(timestamp, pose, scan)) {
+        env.storeData(scan);
+        frames++;
+        rays += scan.size();
+    }
+    double sec = GetTime() - start;
+
+    printf("%s (%s): %zu scans, %zu measurements, %.1f MB\n", logFile, log.MapFile().c_str(),
+           frames, rays, log.Bytes() / (1024.0 * 1024.0));
+    printf("replay: %.0f scans/s, %d hit cells\n", frames / sec, env.hits.OccupiedCells());
+    CloseWindow();
+    return 0;
+}
+
+// Record a synthetic session to a log, then replay it: scans/s for both
+int RunLogBenchmark(const char* mapFile) {
+    const char* logFile = "scan_log_bench.bin";
+    const int scans = 5000;
+    InitWindow(1200, 600, "LIDAR benchmark");
+
+    double recordSec, replaySec, senseSec = 0.0;
+    size_t bytes;
+    {
+        Environment env(mapFile);
+        LaserSensor laser(200, 0.5f, 0.01f);
+        laser.numRays = 360;
+        const float w = (float)env.originalMapImage.width;
+        const float h = (float)env.originalMapImage.height;
+
+        ScanLogWriter writer;
+        if (!writer.Open(logFile, mapFile)) { printf("cannot write %s\n", logFile); CloseWindow(); return 1; }
+        std::vector<std::vector<SensorMeasurement>> frames(scans);
+        std::vector<Vector2> poses(scans);
+        for (int f = 0; f < scans; f++) {
+            poses[f] = { w * (0.5f + 0.45f * sinf(f * 0.013f)), h * (0.5f + 0.45f * sinf(f * 0.021f)) };
+            laser.position = poses[f];
+            double t = GetTime();
+            frames[f] = laser.senseObstacles(env.occupancy, &env.distanceField);
+            senseSec += GetTime() - t;
+        }
+
+        // Time the log writes alone
+        double start = GetTime();
+        for (int f = 0; f < scans; f++) writer.WriteFrame(f / 60.0, poses[f], frames[f]);
+        writer.Close();
+        recordSec = GetTime() - start;
+        bytes = writer.Bytes();
+    }
+    {
+        ScanLogReader log;
+        if (!log.Open(logFile)) { printf("cannot read scan log %s\n", logFile); CloseWindow(); return 1; }
+        Environment env(log.MapFile().c_str());
+        std::vector<SensorMeasurement> scan;
+        double timestamp;
+        Vector2 pose;
+        double start = GetTime();
+        while (log.ReadFrame(timestamp, pose, scan)) env.storeData(scan);
+        replaySec = GetTime() - start;
+    }
+    remove(logFile);
+
+    printf("%s, %d scans x 360 rays, log %.1f MB (%.1f bytes/scan)\n", mapFile, scans,
+           bytes / (1024.0 * 1024.0), (double)bytes / scans);
+    printf("sense:  %10.0f scans/s\n", scans / senseSec);
+    printf("record: %10.0f scans/s\n", scans / recordSec);
+    printf("replay: %10.0f scans/s (read + storeData)\n", scans / replaySec);
+    CloseWindow();
+    return 0;
+}
+
+// Scan endpoints in the sensor frame (sensor at the origin, heading 0)
+static void ScanToLocal(const std::vector<SensorMeasurement>& scan, std::vector<Vector2>& local) {
+    local.resize(scan.size());
+    for (size_t i = 0; i < scan.size(); i++)
+        local[i] = { scan[i].distance * cosf(scan[i].angle), -scan[i].distance * sinf(scan[i].angle) };
+}
+
+// Random walk through free space for the localisation benchmark
+static std::vector<Vector2> FreeSpaceWalk(const DistanceField& field, int steps, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> rx(0, field.Width()), ry(0, field.Height()), ra(0, 2*M_PI);
+    // Start somewhere enclosed: walls in every direction within 400 px
+    auto enclosed = [&](Vector2 p) {
+        for (int k = 0; k < 16; k++) {
+            float hit;
+            if (!field.CastRay(p, k * (2*M_PI) / 16, 400.0f, hit)) return false;
+        }
+        return true;
+    };
+    Vector2 p;
+    do { p = {rx(gen), ry(gen)}; } while (field.At((int)p.x, (int)p.y) < 10.0f || !enclosed(p));
+
+    std::vector<Vector2> path;
+    float heading = ra(gen);
+    while ((int)path.size() < steps) {
+        Vector2 next = {p.x + 3.0f * cosf(heading), p.y - 3.0f * sinf(heading)};
+        if (field.At((int)next.x, (int)next.y) < 5.0f) { heading = ra(gen); continue; }
+        p = next;
+        path.push_back(p);
+    }
+    return path;
+}
+
+// 10k particles x 360 beams: per-stage time and update rate for 1..N
+// threads, plus how far the estimate ends up from the true pose
+int RunMclBenchmark(const char* mapFile, int maxThreads) {
+    Environment env(mapFile);
+    LaserSensor laser(200, 0.5f, 0.01f);
+    laser.gen.seed(7);
+    laser.numRays = 360;
+    const int particles = 10000, steps = 150;
+    std::vector<Vector2> path = FreeSpaceWalk(env.distanceField, steps + 1, 3);
+
+    std::vector<int> threadCounts;
+    for (int t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    printf("%s, %d particles x %d beams, %d updates\n", mapFile, particles, laser.numRays, steps);
+    printf("threads  predict  weight  normalise  resample  total ms      Hz  final error px\n");
+    std::vector<SensorMeasurement> scan;
+    for (int t : threadCounts) {
+        ThreadPool pool(t);
+        ParticleFilter mcl;
+        mcl.Init(particles, env.distanceField, 11);
+
+        MclTimings sum;
+        for (int s = 1; s <= steps; s++) {
+            laser.position = path[s];
+            laser.senseObstaclesParallel(env.occupancy, &env.distanceField, pool, scan);
+            mcl.Step({path[s].x - path[s - 1].x, path[s].y - path[s - 1].y}, scan, pool);
+            sum.predict += mcl.timings.predict;
+            sum.weight += mcl.timings.weight;
+            sum.normalise += mcl.timings.normalise;
+            sum.resample += mcl.timings.resample;
+        }
+        Vector2 est = mcl.Estimate();
+        float error = hypotf(est.x - path[steps].x, est.y - path[steps].y);
+        printf("%7d  %7.2f  %6.2f  %9.2f  %8.2f  %8.2f  %6.1f  %14.1f\n", t,
+               sum.predict / steps, sum.weight / steps, sum.normalise / steps,
+               sum.resample / steps, sum.Total() / steps, 1000.0 * steps / sum.Total(), error);
+    }
+    return 0;
+}
+
+// Nearest-neighbour queries/s and ICP cost per scan, k-d forest vs brute
+// force, against a map built from a 3600-ray survey of the floor plan
+int RunIcpBenchmark(const char* mapFile) {
+    Environment env(mapFile);
+    LaserSensor laser(200, 0.5f, 0.01f);
+    laser.gen.seed(5);
+    ThreadPool pool(1);
+    std::vector<SensorMeasurement> scan;
+
+    // Survey: the forest is filled incrementally by storeData
+    laser.numRays = 3600;
+    std::vector<Vector2> path = FreeSpaceWalk(env.distanceField, 400, 9);
+    double start = GetTime();
+    for (size_t i = 0; i < path.size(); i += 2) {
+        laser.position = path[i];
+        laser.senseObstaclesParallel(env.occupancy, &env.distanceField, pool, scan);
+        env.storeData(scan);
+    }
+    double surveyMs = (GetTime() - start) * 1000.0;
+    std::vector<Vector2> mapList = env.mapPoints.Points();
+    printf("%s: %zu map points in %d trees (survey incl. incremental index: %.1f ms)\n",
+           mapFile, mapList.size(), env.mapPoints.Levels(), surveyMs);
+
+    // Queries scattered around the map points
+    std::mt19937 gen(1);
+    std::normal_distribution<float> jitter(0.0f, 4.0f);
+    std::vector<Vector2> queries(200000);
+    for (auto& q : queries) {
+        Vector2 p = mapList[gen() % mapList.size()];
+        q = {p.x + jitter(gen), p.y + jitter(gen)};
+    }
+    Vector2 best;
+    int found = 0;
+    start = GetTime();
+    for (auto& q : queries) found += env.mapPoints.Nearest(q, 10.0f, best);
+    double kdRate = queries.size() / (GetTime() - start);
+    const int bruteQueries = 2000;
+    start = GetTime();
+    for (int i = 0; i < bruteQueries; i++) found += NearestBruteForce(mapList, queries[i], 10.0f, best);
+    double bruteRate = bruteQueries / (GetTime() - start);
+    printf("NN queries/s:  k-d forest %.0f, brute force %.0f (%.0fx)\n", kdRate, bruteRate, kdRate / bruteRate);
+
+    // ICP from a perturbed guess (5 px, 0.05 rad) at poses along the walk
+    printf("rays  method       scans  iters  ms/scan  final error px\n");
+    std::vector<Vector2> local;
+    for (int rays : {60, 360, 1800, 3600}) {
+        laser.numRays = rays;
+        for (int brute = 0; brute < 2; brute++) {
+            int scans = brute ? 3 : 30;
+            double ms = 0.0, error = 0.0;
+            long iterations = 0;
+            for (int s = 0; s < scans; s++) {
+                Vector2 truth = path[1 + s * 13 % 390];
+                laser.position = truth;
+                laser.senseObstaclesParallel(env.occupancy, &env.distanceField, pool, scan);
+                ScanToLocal(scan, local);
+                Pose2D guess = {truth.x + 4.0f, truth.y - 3.0f, 0.05f};
+
+                double t = GetTime();
+                IcpResult r = brute ? AlignScanBruteForce(local, mapList, guess)
+                                    : AlignScan(local, env.mapPoints, guess);
+                ms += (GetTime() - t) * 1000.0;
+                iterations += r.iterations;
+                error += hypotf(r.pose.x - truth.x, r.pose.y - truth.y);
+            }
+            printf("%4d  %-11s  %5d  %5.1f  %7.2f  %14.2f\n", rays, brute ? "brute force" : "k-d forest",
+                   scans, (double)iterations / scans, ms / scans, error / scans);
+        }
+    }
+    return found > 0 ? 0 : 1;
+}
+
 // ------------------ Main ------------------
-int main() {
+int main(int argc, char** argv) {
+    if (argc > 1 && strcmp(argv[1], "--selftest") == 0) return RunSelfTest();
+    if (argc > 2 && strcmp(argv[1], "--replay") == 0) return RunReplay(argv[2]);
+    if (argc > 1 && strcmp(argv[1], "--bench-icp") == 0) {
+        InitWindow(1200, 600, "LIDAR benchmark");
+        int result = RunIcpBenchmark(argc > 2 ? argv[2] : "assets/floor_plan.png");
+        CloseWindow();
+        return result;
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-log") == 0)
+        return RunLogBenchmark(argc > 2 ? argv[2] : "assets/floor_plan.png");
+    if (argc > 1 && (strcmp(argv[1], "--bench-scan") == 0 || strcmp(argv[1], "--bench-mcl") == 0)) {
+        InitWindow(1200, 600, "LIDAR benchmark");
+        int threads = argc > 3 ? atoi(argv[3]) : (int)std::thread::hardware_concurrency();
+        int (*bench)(const char*, int) = strcmp(argv[1], "--bench-scan") == 0 ? RunScanBenchmark : RunMclBenchmark;
+        int result = bench(argc > 2 ? argv[2] : "assets/floor_plan.png", threads > 0 ? threads : 1);
+        CloseWindow();
+        return result;
+    }
+    if (argc > 1 && (strcmp(argv[1], "--bench") == 0 || strcmp(argv[1], "--bench-upload") == 0)) {
+        // Environment owns textures, so the benchmarks need a GL context
+        InitWindow(1200, 600, "LIDAR benchmark");
+        int (*bench)(const char*) = strcmp(argv[1], "--bench") == 0 ? RunBenchmark : RunUploadBenchmark;
+        int result = 0;
+        if (argc > 2) result = bench(argv[2]);
+        else result = bench("assets/floor_plan.png") | bench("assets/background.png");
+        CloseWindow();
+        return result;
+    }
+
     const int width = 1200;
     const int height = 600;
     InitWindow(width, height, "Laser Sensor Map Reveal");
 
     // Load environment
-    Environment env("assets/floor_plan.png");
+    const char* mapFile = "assets/floor_plan.png";
+    Environment env(mapFile);
 
     // Create laser sensor
     LaserSensor laser(200, 0.5f, 0.01f);
 
     SetTargetFPS(60);
 
+    bool useDistanceField = true;   // D toggles sphere tracing vs plain DDA
+    bool highRes = false;           // H toggles the threaded high-resolution scan
+    int highResRays = 3600;         // +/- change its ray count
+    ThreadPool pool;
+    std::vector<SensorMeasurement> sensorData;
+    ScanLogWriter recorder;         // R starts/stops recording to scan_log.bin
+    ParticleFilter mcl;             // L toggles Monte Carlo localisation
+    bool localise = false;
+    Vector2 lastMousePos = GetMousePosition();
+
+    // I: scans are placed with drifting odometry (mouse delta plus noise)
+    // and registered against the map points by ICP before being stored
+    bool scanMatching = false;
+    Pose2D odometryPose, icpPose;
+    IcpResult icp;
+    double icpMs = 0.0;
+    std::mt19937 odometryGen(3);
+    std::normal_distribution<float> odometryNoise(0.0f, 0.3f), headingDrift(0.0f, 0.002f);
+    std::vector<Vector2> localScan;
+
     while (!WindowShouldClose()) {
+        if (IsKeyPressed(KEY_D)) useDistanceField = !useDistanceField;
+        if (IsKeyPressed(KEY_U)) env.fullUploads = !env.fullUploads;
+        if (IsKeyPressed(KEY_H)) highRes = !highRes;
+        if (IsKeyPressed(KEY_I)) {
+            scanMatching = !scanMatching;
+            Vector2 m = GetMousePosition();
+            odometryPose = icpPose = {m.x, m.y, 0.0f};
+        }
+        if (IsKeyPressed(KEY_L)) {
+            localise = !localise;
+            if (localise) mcl.Init(10000, env.distanceField, (unsigned)(GetTime() * 1000.0));
+        }
+        if (IsKeyPressed(KEY_R)) {
+            if (recorder.IsOpen()) {
+                recorder.Close();
+                TraceLog(LOG_INFO, "Recorded %d scans to scan_log.bin", recorder.Frames());
+            } else if (!recorder.Open("scan_log.bin", mapFile)) {
+                TraceLog(LOG_WARNING, "Cannot open scan_log.bin");
+            }
+        }
+        if (IsKeyPressed(KEY_EQUAL)) highResRays = std::min(highResRays * 2, 36000);
+        if (IsKeyPressed(KEY_MINUS) && highResRays > 360) highResRays /= 2;
+
+        // P exports the deduplicated scan points
+        if (IsKeyPressed(KEY_P)) {
+            if (env.hits.ExportPoints("scan_points.csv"))
+                TraceLog(LOG_INFO, "Exported %d points to scan_points.csv", env.hits.OccupiedCells());
+        }
+
         // Move sensor to mouse position
         Vector2 mousePos = GetMousePosition();
         laser.position = mousePos;
 
         // Sense obstacles
-        auto sensorData = laser.senseObstacles(env.originalMapImage);
+        const DistanceField* field = useDistanceField ? &env.distanceField : nullptr;
+        double scanStart = GetTime();
+        if (highRes || localise) {
+            laser.numRays = highRes ? highResRays : 360;
+            laser.senseObstaclesParallel(env.occupancy, field, pool, sensorData);
+        } else {
+            laser.numRays = 60;
+            sensorData = laser.senseObstacles(env.occupancy, field);
+        }
+        double scanMs = (GetTime() - scanStart) * 1000.0;
+        if (recorder.IsOpen()) recorder.WriteFrame(GetTime(), laser.position, sensorData);
+
+        // The mouse delta stands in for odometry
+        if (localise) mcl.Step({mousePos.x - lastMousePos.x, mousePos.y - lastMousePos.y}, sensorData, pool);
+
+        if (scanMatching) {
+            float dx = mousePos.x - lastMousePos.x + odometryNoise(odometryGen);
+            float dy = mousePos.y - lastMousePos.y + odometryNoise(odometryGen);
+            float dt = headingDrift(odometryGen);
+            odometryPose = {odometryPose.x + dx, odometryPose.y + dy, odometryPose.theta + dt};
+            Pose2D guess = {icpPose.x + dx, icpPose.y + dy, icpPose.theta + dt};
+
+            ScanToLocal(sensorData, localScan);
+            double icpStart = GetTime();
+            icp = env.mapPoints.Size() > 100 ? AlignScan(localScan, env.mapPoints, guess) : IcpResult{guess};
+            icpMs = (GetTime() - icpStart) * 1000.0;
+            icpPose = icp.pose;
+
+            // Store the scan where ICP placed it (R(theta) turns angle a into a - theta)
+            for (auto& m : sensorData) {
+                m.position = {icpPose.x, icpPose.y};
+                m.angle -= icpPose.theta;
+            }
+        }
+        lastMousePos = mousePos;
         env.storeData(sensorData);
 
         // Draw everything
@@ -168,6 +820,34 @@ int main() {
         // Draw accumulated point cloud
         env.drawSensorData();
 
+        DrawText(useDistanceField ? "rays: distance field (D)" : "rays: grid DDA (D)", 10, 10, 20, GRAY);
+        DrawText(TextFormat("%d hit cells, %.1f MB (P = export)", env.hits.OccupiedCells(),
+                            env.hits.MemoryBytes() / (1024.0 * 1024.0)), 10, 35, 20, GRAY);
+        DrawText(TextFormat("upload: %.1f KB/frame, %s (U)", env.uploadedBytes / 1024.0,
+                            env.fullUploads ? "full textures" : "dirty tiles"), 10, 60, 20, GRAY);
+        DrawText(TextFormat("%d rays, %.2f ms, %d thread(s) (H, +/-)", laser.numRays, scanMs,
+                            highRes ? pool.Size() : 1), 10, 85, 20, GRAY);
+        if (localise) {
+            float spread;
+            Vector2 est = mcl.Estimate(nullptr, &spread);
+            mcl.Draw();
+            DrawCircleLinesV(est, fmaxf(spread, 4.0f), YELLOW);
+            const MclTimings& t = mcl.timings;
+            DrawText(TextFormat("MCL %d particles: predict %.2f weight %.2f norm %.2f resample %.2f ms, error %.1f px (L)",
+                                mcl.Size(), t.predict, t.weight, t.normalise, t.resample,
+                                hypotf(est.x - mousePos.x, est.y - mousePos.y)), 10, 135, 20, YELLOW);
+        }
+        if (scanMatching) {
+            DrawCircleLinesV({odometryPose.x, odometryPose.y}, 6, ORANGE);
+            DrawCircleLinesV({icpPose.x, icpPose.y}, 6, YELLOW);
+            DrawText(TextFormat("ICP %d iters, %.2f ms, rms %.2f px: error %.1f px (odometry only %.1f px) (I)",
+                                icp.iterations, icpMs, icp.rms,
+                                hypotf(icpPose.x - mousePos.x, icpPose.y - mousePos.y),
+                                hypotf(odometryPose.x - mousePos.x, odometryPose.y - mousePos.y)), 10, 160, 20, YELLOW);
+        }
+        if (recorder.IsOpen())
+            DrawText(TextFormat("REC %d scans (R)", recorder.Frames()), 10, 110, 20, RED);
+
         EndDrawing();
     }
 
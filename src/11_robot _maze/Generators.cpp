@@ -0,0 +1,190 @@
+#include "Generators.h"
+#include <random>
+#include <utility>
+#include <vector>
+
+// Step offsets by direction: TOP, RIGHT, BOTTOM, LEFT
+static const int DX[4] = {0, 1, 0, -1};
+static const int DY[4] = {-1, 0, 1, 0};
+
+// For a 4-bit mask of allowed directions: how many there are, and the
+// k-th one. Choosing a neighbour is then one random number and two table
+// reads instead of building a list.
+struct DirectionTable {
+    uint8_t count[16];
+    uint8_t pick[16][4];
+
+    DirectionTable() {
+        for (int mask = 0; mask < 16; mask++) {
+            count[mask] = 0;
+            for (int d = 0; d < 4; d++) {
+                pick[mask][d] = 0;
+                if (mask & (1 << d)) pick[mask][count[mask]++] = (uint8_t)d;
+            }
+        }
+    }
+};
+static const DirectionTable TABLE;
+
+// Uniform integer in [0, n) from one 32-bit draw, without a division
+static inline uint32_t RandomBelow(std::mt19937& gen, uint32_t n) {
+    return (uint32_t)(((uint64_t)gen() * n) >> 32);
+}
+
+// Directions that stay inside the maze
+static inline int InsideMask(int x, int y, int w, int h) {
+    return (y > 0) | (x < w - 1) << 1 | (y < h - 1) << 2 | (x > 0) << 3;
+}
+
+// 2 bits per entry, packed 32 to a word
+static inline int Get2(const std::vector<uint64_t>& v, size_t i) {
+    return (int)(v[i >> 5] >> (2 * (i & 31))) & 3;
+}
+static inline void Set2(std::vector<uint64_t>& v, size_t i, int value) {
+    int shift = 2 * (i & 31);
+    v[i >> 5] = (v[i >> 5] & ~(3ull << shift)) | (uint64_t)value << shift;
+}
+
+const char* GeneratorName(Generator generator) {
+    switch (generator) {
+        case GEN_BACKTRACKER: return "backtracker";
+        case GEN_WILSON: return "Wilson";
+        case GEN_KRUSKAL: return "Kruskal";
+        default: return "?";
+    }
+}
+
+void GenerateBacktracker(Maze& maze, uint32_t seed) {
+    std::mt19937 gen(seed);
+    const int w = maze.Cols(), h = maze.Rows();
+    const size_t n = (size_t)w * h;
+
+    // Visited flags with a one-cell border that starts out visited, so the
+    // neighbour test needs no bounds checks
+    const int stride = w + 2;
+    const long long padded[4] = {-(long long)stride, 1, stride, -1};
+    const long long offset[4] = {-(long long)w, 1, w, -1};
+    BitGrid visited;
+    visited.Reset(stride, h + 2);
+    for (int x = 0; x < stride; x++) { visited.Set(x, 0); visited.Set(x, h + 1); }
+    for (int y = 0; y < h + 2; y++) { visited.Set(0, y); visited.Set(stride - 1, y); }
+
+    // Every cell is pushed at most once, so n entries always suffice
+    std::vector<uint64_t> stack((n + 31) / 32);
+    size_t depth = 0;
+
+    size_t i = 0;                   // cell index in the maze
+    size_t p = (size_t)stride + 1;  // the same cell in the padded grid
+    visited.Set(p);
+    for (;;) {
+        int open = (!visited.Get(p + padded[TOP])) |
+                   (!visited.Get(p + padded[RIGHT])) << 1 |
+                   (!visited.Get(p + padded[BOTTOM])) << 2 |
+                   (!visited.Get(p + padded[LEFT])) << 3;
+
+        if (open) {
+            int d = TABLE.pick[open][RandomBelow(gen, TABLE.count[open])];
+            maze.RemoveWall(i, (Direction)d);
+            i += offset[d];
+            p += padded[d];
+            visited.Set(p);
+            Set2(stack, depth++, d);
+        } else {
+            // Dead end: step back the way we came
+            if (depth == 0) break;
+            int d = Get2(stack, --depth);
+            i -= offset[d];
+            p -= padded[d];
+        }
+    }
+}
+
+void GenerateWilson(Maze& maze, uint32_t seed) {
+    std::mt19937 gen(seed);
+    const int w = maze.Cols(), h = maze.Rows();
+    const size_t n = (size_t)w * h;
+    const long long offset[4] = {-(long long)w, 1, w, -1};
+
+    BitGrid inTree;
+    inTree.Reset(w, h);
+    // Last direction the current walk left each cell by. Revisiting a
+    // cell overwrites it, which erases the loop.
+    std::vector<uint64_t> exitDir((n + 31) / 32);
+
+    inTree.Set((size_t)RandomBelow(gen, (uint32_t)n));
+    for (size_t start = 0; start < n; start++) {
+        if (inTree.Get(start)) continue;
+
+        // Random walk until the tree is hit
+        int x = (int)(start % w), y = (int)(start / w);
+        size_t i = start;
+        while (!inTree.Get(i)) {
+            int mask = InsideMask(x, y, w, h);
+            int d = TABLE.pick[mask][RandomBelow(gen, TABLE.count[mask])];
+            Set2(exitDir, i, d);
+            x += DX[d];
+            y += DY[d];
+            i += offset[d];
+        }
+
+        // Add the loop-erased path to the tree
+        x = (int)(start % w);
+        y = (int)(start / w);
+        i = start;
+        while (!inTree.Get(i)) {
+            int d = Get2(exitDir, i);
+            inTree.Set(i);
+            maze.RemoveWall(i, (Direction)d);
+            x += DX[d];
+            y += DY[d];
+            i += offset[d];
+        }
+    }
+}
+
+void GenerateKruskal(Maze& maze, uint32_t seed) {
+    std::mt19937 gen(seed);
+    const int w = maze.Cols(), h = maze.Rows();
+    const size_t n = (size_t)w * h;
+
+    // Interior edges as cell * 2 + (0 = right wall, 1 = bottom wall)
+    std::vector<uint32_t> edges;
+    edges.reserve(2 * n);
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            uint32_t cell = (uint32_t)((size_t)y * w + x);
+            if (x < w - 1) edges.push_back(cell * 2);
+            if (y < h - 1) edges.push_back(cell * 2 + 1);
+        }
+    }
+    for (size_t k = edges.size(); k > 1; k--)
+        std::swap(edges[k - 1], edges[RandomBelow(gen, (uint32_t)k)]);
+
+    // Union-find with path halving
+    std::vector<uint32_t> parent(n);
+    for (size_t k = 0; k < n; k++) parent[k] = (uint32_t)k;
+    auto find = [&](uint32_t a) {
+        while (parent[a] != a) {
+            parent[a] = parent[parent[a]];
+            a = parent[a];
+        }
+        return a;
+    };
+
+    size_t joined = 0;
+    for (uint32_t e : edges) {
+        uint32_t a = e >> 1;
+        uint32_t b = (e & 1) ? a + w : a + 1;
+        uint32_t ra = find(a), rb = find(b);
+        if (ra == rb) continue;
+        parent[ra] = rb;
+        maze.RemoveWall((size_t)a, (e & 1) ? BOTTOM : RIGHT);
+        if (++joined == n - 1) break;   // spanning tree complete
+    }
+}
+
+void Generate(Maze& maze, Generator generator, uint32_t seed) {
+    if (generator == GEN_WILSON) GenerateWilson(maze, seed);
+    else if (generator == GEN_KRUSKAL) GenerateKruskal(maze, seed);
+    else GenerateBacktracker(maze, seed);
+}
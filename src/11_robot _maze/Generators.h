@@ -0,0 +1,25 @@
+#pragma once
+#include "Maze.h"
+#include <cstdint>
+
+// Run-to-completion maze generators. Each one starts from a maze with
+// every wall up and carves a perfect maze (a spanning tree of the cells)
+// in one go, without drawing anything.
+enum Generator {GEN_BACKTRACKER, GEN_WILSON, GEN_KRUSKAL, GENERATOR_COUNT};
+
+const char* GeneratorName(Generator generator);
+
+// Iterative depth-first backtracker. The stack holds the 2-bit direction
+// taken into each cell, preallocated for the worst case, and backtracking
+// walks the opposite way. Long corridors, few dead ends.
+void GenerateBacktracker(Maze& maze, uint32_t seed);
+
+// Wilson's algorithm: loop-erased random walks, giving a uniform spanning
+// tree. Slow to start on big mazes while the tree is still small.
+void GenerateWilson(Maze& maze, uint32_t seed);
+
+// Randomised Kruskal: shuffled edges joined with union-find. Needs 12
+// bytes per cell of scratch, so it suits mazes up to a few thousand wide.
+void GenerateKruskal(Maze& maze, uint32_t seed);
+
+void Generate(Maze& maze, Generator generator, uint32_t seed);
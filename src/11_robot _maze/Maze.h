@@ -0,0 +1,126 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Directions used for removing walls
+enum Direction {TOP, RIGHT, BOTTOM, LEFT};
+
+// One bit per cell in a single flat array, for visited / discovered flags
+class BitGrid {
+public:
+    void Reset(int cols, int rows) {
+        width = cols;
+        bits.assign(((size_t)cols * rows + 63) / 64, 0);
+    }
+
+    bool Get(int x, int y) const {
+        size_t i = (size_t)y * width + x;
+        return (bits[i >> 6] >> (i & 63)) & 1;
+    }
+    void Set(int x, int y) {
+        size_t i = (size_t)y * width + x;
+        bits[i >> 6] |= 1ull << (i & 63);
+    }
+
+    // By flat index y * cols + x
+    bool Get(size_t i) const { return (bits[i >> 6] >> (i & 63)) & 1; }
+    void Set(size_t i) { bits[i >> 6] |= 1ull << (i & 63); }
+
+    size_t MemoryBytes() const { return bits.size() * sizeof(uint64_t); }
+
+private:
+    int width = 0;
+    std::vector<uint64_t> bits;
+};
+
+// Directions packed 2 bits each, 32 to a word: push the way each step
+// went and pop to walk a path back. Grows a word at a time and keeps its
+// peak size, so MemoryBytes() reports the deepest the stack has been.
+class DirectionStack {
+public:
+    void Clear() { depth = 0; }
+    bool Empty() const { return depth == 0; }
+    size_t Size() const { return depth; }
+
+    void Push(Direction dir) {
+        if ((depth >> 5) == words.size()) words.push_back(0);
+        int shift = 2 * (depth & 31);
+        uint64_t& w = words[depth >> 5];
+        w = (w & ~(3ull << shift)) | (uint64_t)dir << shift;
+        depth++;
+    }
+    Direction Pop() {
+        depth--;
+        return (Direction)((words[depth >> 5] >> (2 * (depth & 31))) & 3);
+    }
+
+    size_t MemoryBytes() const { return words.capacity() * sizeof(uint64_t); }
+
+private:
+    std::vector<uint64_t> words;
+    size_t depth = 0;
+};
+
+// Maze walls packed 2 bits per cell: each cell stores only its right and
+// bottom walls. A cell's top wall is the bottom wall of the cell above and
+// its left wall the right wall of the cell to its left, so every shared
+// edge is stored once. The outer border always counts as a wall.
+class Maze {
+public:
+    // All walls up
+    void Reset(int cols, int rows) {
+        width = cols;
+        height = rows;
+        walls.assign(((size_t)cols * rows + 31) / 32, ~0ull);
+    }
+
+    int Cols() const { return width; }
+    int Rows() const { return height; }
+
+    bool RightWall(int x, int y) const { return x == width - 1 || Bit(x, y, 0); }
+    bool BottomWall(int x, int y) const { return y == height - 1 || Bit(x, y, 1); }
+    bool TopWall(int x, int y) const { return y == 0 || Bit(x, y - 1, 1); }
+    bool LeftWall(int x, int y) const { return x == 0 || Bit(x - 1, y, 0); }
+
+    bool Wall(int x, int y, Direction dir) const {
+        switch (dir) {
+            case TOP: return TopWall(x, y);
+            case RIGHT: return RightWall(x, y);
+            case BOTTOM: return BottomWall(x, y);
+            default: return LeftWall(x, y);
+        }
+    }
+
+    // Remove the wall between (x, y) and its neighbour in direction dir
+    void RemoveWall(int x, int y, Direction dir) {
+        if (dir == TOP) Clear(x, y - 1, 1);
+        else if (dir == RIGHT) Clear(x, y, 0);
+        else if (dir == BOTTOM) Clear(x, y, 1);
+        else Clear(x - 1, y, 0);
+    }
+
+    // Same, for the cell at flat index i = y * cols + x. No branches, for
+    // the generators' inner loops.
+    void RemoveWall(size_t i, Direction dir) {
+        // TOP and LEFT clear a wall owned by the neighbour
+        long long owner = (long long)i - (dir == TOP) * (long long)width - (dir == LEFT);
+        size_t bit = 2 * (size_t)owner + ((dir & 1) ^ 1);
+        walls[bit >> 6] &= ~(1ull << (bit & 63));
+    }
+
+    size_t MemoryBytes() const { return walls.size() * sizeof(uint64_t); }
+
+private:
+    int width = 0, height = 0;
+    std::vector<uint64_t> walls;   // 32 cells per word: bit 2i = right, 2i+1 = bottom
+
+    bool Bit(int x, int y, int which) const {
+        size_t i = 2 * ((size_t)y * width + x) + which;
+        return (walls[i >> 6] >> (i & 63)) & 1;
+    }
+    void Clear(int x, int y, int which) {
+        size_t i = 2 * ((size_t)y * width + x) + which;
+        walls[i >> 6] &= ~(1ull << (i & 63));
+    }
+};
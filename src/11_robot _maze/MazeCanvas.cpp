@@ -0,0 +1,76 @@
+#include "MazeCanvas.h"
+
+// Fogged walls: white at 40%, which is what the old Fade(BLACK, 0.6f)
+// overlay left of them on the black background
+static const Color FOG_WALL = {102, 102, 102, 255};
+
+void MazeCanvas::Load(int cols, int rows, int cellSize) {
+    width = cols;
+    height = rows;
+    size = cellSize;
+    target = LoadRenderTexture(cols * cellSize, rows * cellSize);
+    MarkAll();
+}
+
+void MazeCanvas::Unload() {
+    UnloadRenderTexture(target);
+}
+
+int MazeCanvas::DrawCell(const Maze& maze, const BitGrid* discovered, int x, int y, bool clear) {
+    int px = x * size, py = y * size;
+    int calls = 0;
+    if (clear) { DrawRectangle(px, py, size, size, BLACK); calls++; }
+
+    Color wall = (discovered && !discovered->Get(x, y)) ? FOG_WALL : WHITE;
+    if (maze.TopWall(x, y)) { DrawRectangle(px, py, size, 1, wall); calls++; }
+    if (maze.LeftWall(x, y)) { DrawRectangle(px, py, 1, size, wall); calls++; }
+    return calls;
+}
+
+int MazeCanvas::Update(const Maze& maze, const BitGrid* discovered) {
+    if (!all && dirty.empty()) return 0;
+
+    int calls = 0;
+    BeginTextureMode(target);
+    if (all) {
+        ClearBackground(BLACK);
+        for (int y = 0; y < height; y++)
+            for (int x = 0; x < width; x++)
+                calls += DrawCell(maze, discovered, x, y, false);
+        all = false;
+    } else {
+        for (uint32_t i : dirty)
+            calls += DrawCell(maze, discovered, (int)(i % width), (int)(i / width), true);
+    }
+    EndTextureMode();
+    dirty.clear();
+    return calls;
+}
+
+void MazeCanvas::Draw() const {
+    // Render textures are stored upside down: flip with a negative height
+    DrawTextureRec(target.texture,
+                   {0, 0, (float)target.texture.width, -(float)target.texture.height},
+                   {0, 0}, WHITE);
+}
+
+int DrawMazeImmediate(const Maze& maze, const BitGrid* discovered, int cellSize) {
+    int calls = 0;
+    for (int y = 0; y < maze.Rows(); y++) {
+        for (int x = 0; x < maze.Cols(); x++) {
+            int px = x * cellSize;
+            int py = y * cellSize;
+
+            if (maze.TopWall(x,y)) { DrawLine(px,py,px+cellSize,py,WHITE); calls++; }
+            if (maze.RightWall(x,y)) { DrawLine(px+cellSize,py,px+cellSize,py+cellSize,WHITE); calls++; }
+            if (maze.BottomWall(x,y)) { DrawLine(px,py+cellSize,px+cellSize,py+cellSize,WHITE); calls++; }
+            if (maze.LeftWall(x,y)) { DrawLine(px,py,px,py+cellSize,WHITE); calls++; }
+
+            if (discovered && !discovered->Get(x,y)) {
+                DrawRectangle(px,py,cellSize,cellSize,Fade(BLACK,0.6f));
+                calls++;
+            }
+        }
+    }
+    return calls;
+}
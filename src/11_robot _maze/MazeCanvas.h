@@ -0,0 +1,41 @@
+#pragma once
+#include "raylib.h"
+#include "Maze.h"
+#include <cstdint>
+#include <vector>
+
+// Maze walls and fog kept in a render texture. Walls only change during
+// generation and fog only when a cell is discovered, so cells are redrawn
+// into the texture only when marked dirty and a frame costs a few draw
+// calls whatever the maze size.
+//
+// Each cell owns its top and left walls and paints only inside its own
+// square, so redrawing one cell never disturbs its neighbours. Removing a
+// wall must therefore mark both cells beside it.
+class MazeCanvas {
+public:
+    void Load(int cols, int rows, int cellSize);
+    void Unload();
+
+    void MarkAll() { all = true; dirty.clear(); }
+    void Mark(int x, int y) { if (!all) dirty.push_back((uint32_t)y * width + x); }
+
+    // Redraw the dirty cells into the texture. discovered is null while
+    // there is no fog. Returns the number of draw calls issued.
+    int Update(const Maze& maze, const BitGrid* discovered);
+
+    // Blit the texture to the screen: one draw call
+    void Draw() const;
+
+private:
+    RenderTexture2D target = {};
+    int width = 0, height = 0, size = 0;
+    bool all = true;
+    std::vector<uint32_t> dirty;
+
+    int DrawCell(const Maze& maze, const BitGrid* discovered, int x, int y, bool clear);
+};
+
+// The old way: every wall of every cell plus a fog rectangle, straight to
+// the screen. Kept for comparing draw calls; returns how many it issued.
+int DrawMazeImmediate(const Maze& maze, const BitGrid* discovered, int cellSize);
@@ -0,0 +1,165 @@
+#include "MazeStream.h"
+#include <algorithm>
+
+static const uint32_t UNSET = 0xFFFFFFFFu;
+
+static inline uint64_t SplitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Random stream for one row: a hash of (seed, row)
+static inline uint64_t RowState(uint64_t seed, long long row) {
+    uint64_t mix = seed ^ ((uint64_t)row * 0xD1B54A32D192ED03ull);
+    return SplitMix64(mix);
+}
+
+static inline uint32_t RandomBelow(uint64_t& state, uint32_t n) {
+    return (uint32_t)(((SplitMix64(state) >> 32) * n) >> 32);
+}
+
+void MazeStream::Reset(int cols, uint64_t mazeSeed, int keepRows, int checkpointEvery) {
+    width = cols;
+    words = (2 * cols + 63) / 64;
+    seed = mazeSeed;
+    every = std::max(1, checkpointEvery);
+
+    // Row 0: every cell in its own set
+    sets.resize(width);
+    for (int x = 0; x < width; x++) sets[x] = (uint32_t)x;
+    frontier = 0;
+
+    capacity = std::max(2, keepRows);
+    ring.assign((size_t)capacity * words, 0);
+    ringRow.assign(capacity, -1);
+
+    scratch.parent.resize(width);
+    scratch.count.resize(width);
+    scratch.candidate.resize(width);
+    scratch.remap.resize(width);
+    scratch.hasDown.resize(width);
+    scratch.down.resize(width);
+}
+
+void MazeStream::CarveRow(long long y, std::vector<uint32_t>& labels, uint64_t* walls) const {
+    Scratch& s = scratch;
+    uint64_t rng = RowState(seed, y);
+    for (int k = 0; k < words; k++) walls[k] = ~0ull;
+
+    // Labels are below width, so a union-find over them tracks the merges
+    for (int k = 0; k < width; k++) s.parent[k] = (uint32_t)k;
+    auto find = [&](uint32_t a) {
+        while (s.parent[a] != a) {
+            s.parent[a] = s.parent[s.parent[a]];
+            a = s.parent[a];
+        }
+        return a;
+    };
+
+    // Horizontal: join neighbours from different sets with probability 1/2.
+    // The row before a checkpoint joins them all, leaving a single set.
+    bool mergeAll = (y + 1) % every == 0;
+    uint64_t bits = 0;
+    int left = 0;
+    for (int x = 0; x < width - 1; x++) {
+        if (left == 0) { bits = SplitMix64(rng); left = 64; }
+        bool join = bits & 1;
+        bits >>= 1;
+        left--;
+        uint32_t a = find(labels[x]), b = find(labels[x + 1]);
+        if ((join || mergeAll) && a != b) {
+            s.parent[b] = a;
+            walls[(2 * x) >> 6] &= ~(1ull << ((2 * x) & 63));
+        }
+    }
+
+    // Vertical: each cell opens downwards with probability 1/2...
+    for (int k = 0; k < width; k++) {
+        s.count[k] = 0;
+        s.hasDown[k] = 0;
+        s.candidate[k] = UNSET;
+    }
+    for (int x = 0; x < width; x++) {
+        if (left == 0) { bits = SplitMix64(rng); left = 64; }
+        s.down[x] = bits & 1;
+        bits >>= 1;
+        left--;
+        uint32_t r = find(labels[x]);
+        s.hasDown[r] |= s.down[x];
+        s.count[r]++;
+    }
+    // ...and a set with no opening gets one at a random member, so every
+    // set carries on into the next row
+    for (int x = 0; x < width; x++) {
+        uint32_t r = find(labels[x]);
+        if (s.hasDown[r]) continue;
+        if (s.candidate[r] == UNSET) s.candidate[r] = RandomBelow(rng, s.count[r]);
+        if (s.candidate[r]-- == 0) {
+            s.down[x] = 1;
+            s.hasDown[r] = 1;
+        }
+    }
+
+    // Open the bottoms and label the next row: cells below an opening keep
+    // their set, the rest start new ones
+    for (int k = 0; k < width; k++) s.remap[k] = UNSET;
+    uint32_t next = 0;
+    for (int x = 0; x < width; x++) {
+        if (s.down[x]) {
+            walls[(2 * x + 1) >> 6] &= ~(1ull << ((2 * x + 1) & 63));
+            uint32_t r = find(labels[x]);
+            if (s.remap[r] == UNSET) s.remap[r] = next++;
+            labels[x] = s.remap[r];
+        } else {
+            labels[x] = next++;
+        }
+    }
+}
+
+void MazeStream::Rebuild(long long y, uint64_t* walls) const {
+    long long start = (y / every) * every;
+    std::vector<uint32_t> labels(width);
+    for (int x = 0; x < width; x++) labels[x] = (uint32_t)x;
+    // The row before the checkpoint ends as one set whatever labels it
+    // starts from, so carving it from any labels gives the checkpoint's
+    if (start > 0) CarveRow(start - 1, labels, walls);
+    for (long long r = start; r <= y; r++) CarveRow(r, labels, walls);
+}
+
+const uint64_t* MazeStream::Row(long long y) {
+    int slot = (int)(y % capacity);
+    uint64_t* walls = &ring[(size_t)slot * words];
+    if (ringRow[slot] == y) return walls;
+
+    if (y < frontier) {
+        // Dropped earlier: rebuild from the checkpoint before it
+        Rebuild(y, walls);
+        ringRow[slot] = y;
+        return walls;
+    }
+
+    // Stream forwards
+    while (frontier <= y) {
+        int s = (int)(frontier % capacity);
+        CarveRow(frontier, sets, &ring[(size_t)s * words]);
+        ringRow[s] = frontier;
+        frontier++;
+    }
+    return walls;
+}
+
+void MazeStream::RegenerateRow(long long y, std::vector<uint64_t>& out) const {
+    out.resize(words);
+    Rebuild(y, out.data());
+}
+
+size_t MazeStream::MemoryBytes() const {
+    size_t bytes = ring.capacity() * sizeof(uint64_t) + ringRow.capacity() * sizeof(long long) +
+                   sets.capacity() * sizeof(uint32_t);
+    bytes += (scratch.parent.capacity() + scratch.count.capacity() + scratch.candidate.capacity() +
+              scratch.remap.capacity()) * sizeof(uint32_t) +
+             scratch.hasDown.capacity() + scratch.down.capacity();
+    return bytes;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// An endless maze, fixed width and unbounded downwards, generated one row
+// at a time with Eller's algorithm. Only the set label of each cell in the
+// current row carries from one row to the next, so generation needs
+// memory proportional to the width.
+//
+// Each row draws its random numbers from hash(seed, row), so a row depends
+// only on the seed and the set labels it starts from. Every checkpointEvery
+// rows the row before joins all its cells into one set, which makes the
+// labels of the checkpoint row a function of the seed alone. Any row can
+// then be rebuilt by replaying at most checkpointEvery + 1 rows, and
+// nothing is stored per checkpoint.
+//
+// Rows live in a small ring (keepRows slots). Asking for a row that is not
+// there generates it forwards or rebuilds it from a checkpoint, evicting
+// whatever row shared its slot, so rows behind the viewport are dropped as
+// the viewport moves on.
+class MazeStream {
+public:
+    void Reset(int cols, uint64_t seed, int keepRows, int checkpointEvery = 256);
+
+    int Cols() const { return width; }
+    long long RowsGenerated() const { return frontier; }
+
+    // Walls use the Maze layout: 2 bits per cell, right then bottom.
+    // Calls with an unloaded y load that row first.
+    bool RightWall(int x, long long y) { return x == width - 1 || Bit(x, y, 0); }
+    bool BottomWall(int x, long long y) { return Bit(x, y, 1); }
+    bool TopWall(int x, long long y) { return y == 0 || Bit(x, y - 1, 1); }
+    bool LeftWall(int x, long long y) { return x == 0 || Bit(x - 1, y, 0); }
+
+    // Packed walls of a row, loading it into the ring if needed. The
+    // pointer stays valid until a row that maps to the same slot is loaded.
+    const uint64_t* Row(long long y);
+
+    // Rebuild a row from the nearest checkpoint into out, leaving the ring
+    // and the stream untouched. y must not be past RowsGenerated().
+    void RegenerateRow(long long y, std::vector<uint64_t>& out) const;
+
+    size_t MemoryBytes() const;
+
+private:
+    int width = 0;
+    int words = 0;              // uint64 words per row
+    uint64_t seed = 0;
+    int every = 256;
+
+    // Forward stream: set labels for row frontier, before it is carved
+    std::vector<uint32_t> sets;
+    long long frontier = 0;
+
+    // Ring of loaded rows
+    int capacity = 0;
+    std::vector<uint64_t> ring;
+    std::vector<long long> ringRow;   // row held by each slot, -1 if none
+
+    // Per-row scratch for CarveRow
+    struct Scratch {
+        std::vector<uint32_t> parent, count, candidate, remap;
+        std::vector<uint8_t> hasDown, down;
+    };
+    mutable Scratch scratch;
+
+    // Carve row y into walls given its labels; leaves the labels of row
+    // y + 1 in labels, renumbered 0.. in order of first appearance
+    void CarveRow(long long y, std::vector<uint32_t>& labels, uint64_t* walls) const;
+    void Rebuild(long long y, uint64_t* walls) const;
+
+    bool Bit(int x, long long y, int which) {
+        size_t i = 2 * (size_t)x + which;
+        return (Row(y)[i >> 6] >> (i & 63)) & 1;
+    }
+};
@@ -51,27 +51,22 @@
  ******************************************************************/
 
 #include "raylib.h"
+#include "Maze.h"
+#include "Generators.h"
+#include "MazeStream.h"
+#include "MazeCanvas.h"
 #include <vector>
 #include <stack>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
+#include <chrono>
 #include <algorithm>
 
-// Each cell in the maze has walls on all sides and a visited flag
-struct Cell {
-    bool visited = false;
-    bool topWall = true;
-    bool rightWall = true;
-    bool bottomWall = true;
-    bool leftWall = true;
-};
-
-const int cols = 30;   // number of columns in the maze
-const int rows = 15;   // number of rows in the maze
-const int cellSize = 40; // size of each cell in pixels
-
-// Directions used for removing walls
-enum Direction {TOP, RIGHT, BOTTOM, LEFT};
+int cols = 30;     // number of columns in the maze
+int rows = 15;     // number of rows in the maze
+int cellSize = 40; // size of each cell in pixels
 
 // State of the program: generating maze, exploring maze, or finished
 enum State {GENERATING, EXPLORING, FINISHED};
@@ -79,35 +74,51 @@ enum State {GENERATING, EXPLORING, FINISHED};
 State state = GENERATING; // start with maze generation
 
 // Check for unvisited neighbors around the current cell
-bool getUnvisitedNeighbor(int x, int y,
-                          std::vector<std::vector<Cell>>& grid,
+bool getUnvisitedNeighbor(int x, int y, const BitGrid& visited,
                           int& nx, int& ny, Direction& dir)
 {
-    std::vector<std::pair<std::pair<int,int>, Direction>> neighbors;
+    // At most four candidates, so keep them on the stack rather than
+    // allocating a vector for every step
+    Direction neighbors[4];
+    int count = 0;
 
     // Add unvisited neighbors to the list
-    if (y > 0 && !grid[y-1][x].visited) neighbors.push_back({{x,y-1}, TOP});
-    if (x < cols-1 && !grid[y][x+1].visited) neighbors.push_back({{x+1,y}, RIGHT});
-    if (y < rows-1 && !grid[y+1][x].visited) neighbors.push_back({{x,y+1}, BOTTOM});
-    if (x > 0 && !grid[y][x-1].visited) neighbors.push_back({{x-1,y}, LEFT});
+    if (y > 0 && !visited.Get(x,y-1)) neighbors[count++] = TOP;
+    if (x < cols-1 && !visited.Get(x+1,y)) neighbors[count++] = RIGHT;
+    if (y < rows-1 && !visited.Get(x,y+1)) neighbors[count++] = BOTTOM;
+    if (x > 0 && !visited.Get(x-1,y)) neighbors[count++] = LEFT;
 
-    if (!neighbors.empty()) {
+    if (count > 0) {
         // Pick a random neighbor to continue maze generation
-        int i = rand() % neighbors.size();
-        nx = neighbors[i].first.first;
-        ny = neighbors[i].first.second;
-        dir = neighbors[i].second;
+        dir = neighbors[rand() % count];
+        nx = x + (dir == RIGHT) - (dir == LEFT);
+        ny = y + (dir == BOTTOM) - (dir == TOP);
         return true;
     }
     return false; // no unvisited neighbors left
 }
 
-// Remove the wall between two adjacent cells
-void removeWall(Cell &current, Cell &next, Direction dir) {
-    if (dir == TOP) { current.topWall = false; next.bottomWall = false; }
-    else if (dir == RIGHT) { current.rightWall = false; next.leftWall = false; }
-    else if (dir == BOTTOM) { current.bottomWall = false; next.topWall = false; }
-    else if (dir == LEFT) { current.leftWall = false; next.rightWall = false; }
+// One step of recursive backtracking; returns false once the maze is done.
+// Cells whose walls change are marked on canvas, if given.
+bool generationStep(Maze& maze, BitGrid& visited,
+                    std::stack<std::pair<int,int>>& genStack,
+                    MazeCanvas* canvas = nullptr)
+{
+    if (genStack.empty()) return false;
+
+    auto [x,y] = genStack.top();
+    int nx, ny;
+    Direction dir;
+
+    if (getUnvisitedNeighbor(x,y,visited,nx,ny,dir)) {
+        visited.Set(nx,ny);
+        maze.RemoveWall(x,y,dir);
+        genStack.push({nx,ny});
+        if (canvas) { canvas->Mark(x,y); canvas->Mark(nx,ny); }
+    } else {
+        genStack.pop();
+    }
+    return true;
 }
 
 // Robot structure for exploring the maze
@@ -118,52 +129,50 @@ struct Robot {
     Vector2 position; // actual pixel position (for smooth movement)
     Vector2 target;   // target pixel position to move toward
 
-    std::stack<std::pair<int,int>> stack; // stack to keep track of backtracking
-    std::vector<std::vector<bool>> visited; // visited cells
+    // Way taken into each cell of the current path, for backtracking:
+    // 2 bits per step instead of a cell pair
+    DirectionStack stack;
+    BitGrid visited; // visited cells
 };
 
-// Mark the robot's current cell as discovered
-void senseCell(int x, int y,
-               std::vector<std::vector<Cell>>& grid,
-               std::vector<std::vector<Cell>>& known,
-               std::vector<std::vector<bool>>& discovered)
-{
-    known[y][x] = grid[y][x]; // robot “learns” the cell layout
-    discovered[y][x] = true;  // mark as explored
-}
-
-// Move the robot one step in the maze using DFS logic
-bool explorationStep(Robot& robot,
-                     std::vector<std::vector<Cell>>& grid,
-                     std::vector<std::vector<Cell>>& known,
-                     std::vector<std::vector<bool>>& discovered)
+// Move the robot one step in the maze using DFS logic.
+// The robot only reads walls of cells it has discovered, so its
+// knowledge of the maze is the maze itself masked by discovered.
+bool explorationStep(Robot& robot, const Maze& maze, BitGrid& discovered,
+                     MazeCanvas* canvas = nullptr)
 {
     int x = robot.cellX;
     int y = robot.cellY;
 
-    // Mark current cell as known
-    senseCell(x, y, grid, known, discovered);
+    // Mark current cell as known; its fog lifts
+    if (!discovered.Get(x, y)) {
+        discovered.Set(x, y);
+        if (canvas) canvas->Mark(x, y);
+    }
 
-    std::vector<std::pair<int,int>> neighbors;
-    Cell& c = known[y][x];
+    static const int DX[4] = {0, 1, 0, -1};
+    static const int DY[4] = {-1, 0, 1, 0};
+    Direction neighbors[4];
+    int count = 0;
 
     // Check which directions the robot can move (no wall and not visited)
-    if (!c.topWall && y > 0 && !robot.visited[y-1][x])
-        neighbors.push_back({x, y-1});
-    if (!c.rightWall && x < cols-1 && !robot.visited[y][x+1])
-        neighbors.push_back({x+1, y});
-    if (!c.bottomWall && y < rows-1 && !robot.visited[y+1][x])
-        neighbors.push_back({x, y+1});
-    if (!c.leftWall && x > 0 && !robot.visited[y][x-1])
-        neighbors.push_back({x-1, y});
-
-    if (!neighbors.empty()) {
+    if (!maze.TopWall(x,y) && !robot.visited.Get(x,y-1))
+        neighbors[count++] = TOP;
+    if (!maze.RightWall(x,y) && !robot.visited.Get(x+1,y))
+        neighbors[count++] = RIGHT;
+    if (!maze.BottomWall(x,y) && !robot.visited.Get(x,y+1))
+        neighbors[count++] = BOTTOM;
+    if (!maze.LeftWall(x,y) && !robot.visited.Get(x-1,y))
+        neighbors[count++] = LEFT;
+
+    if (count > 0) {
         // Move to a random unvisited neighbor
-        auto [nx, ny] = neighbors[rand() % neighbors.size()];
+        Direction d = neighbors[rand() % count];
+        int nx = x + DX[d], ny = y + DY[d];
 
-        // Push the new cell onto the stack for future backtracking
-        robot.stack.push({nx, ny});
-        robot.visited[ny][nx] = true; // mark as visited
+        // Push the way we went for future backtracking
+        robot.stack.Push(d);
+        robot.visited.Set(nx, ny); // mark as visited
 
         // Update robot's current cell and target position
         robot.cellX = nx;
@@ -172,14 +181,12 @@ bool explorationStep(Robot& robot,
                         ny * cellSize + cellSize/2.0f};
     } else {
         // No unvisited neighbors → need to backtrack
-        // Pop the current cell from the stack
-        robot.stack.pop();
-
-        // If stack is empty, robot has explored everything
-        if (robot.stack.empty()) return true;
+        // If stack is empty, robot is back at the start and has explored everything
+        if (robot.stack.Empty()) return true;
 
-        // Peek at the next cell to backtrack to
-        auto [bx, by] = robot.stack.top();
+        // Pop the way we came in and step back against it
+        Direction d = robot.stack.Pop();
+        int bx = x - DX[d], by = y - DY[d];
 
         // Move robot back to this previous cell
         robot.cellX = bx;
@@ -194,7 +201,402 @@ bool explorationStep(Robot& robot,
     return false;
 }
 
-int main() {
+// Put the robot on the start cell with nothing visited yet
+void resetRobot(Robot& robot)
+{
+    robot.cellX = 0;
+    robot.cellY = 0;
+    robot.position = {cellSize/2.0f, cellSize/2.0f};
+    robot.target = robot.position;
+    robot.visited.Reset(cols, rows);
+    robot.visited.Set(0, 0);
+    robot.stack.Clear();
+}
+
+// Wall-clock seconds since start. The benchmarks never open a window, and
+// raylib's GetTime() reads 0 until one is open.
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Generate and explore a large maze without a window, reporting time
+// and memory per cell
+int RunBench(int size) {
+    cols = rows = size;
+    srand(1);
+
+    auto t0 = std::chrono::steady_clock::now();
+    Maze maze;
+    maze.Reset(cols, rows);
+    GenerateBacktracker(maze, 1);
+    double genSeconds = SecondsSince(t0);
+
+    t0 = std::chrono::steady_clock::now();
+    Robot robot;
+    BitGrid discovered;
+    discovered.Reset(cols, rows);
+    resetRobot(robot);
+    long long steps = 0;
+    size_t deepest = 0;
+    bool done = false;
+    while (!done && !(robot.cellX == cols-1 && robot.cellY == rows-1)) {
+        done = explorationStep(robot, maze, discovered);
+        deepest = std::max(deepest, robot.stack.Size());
+        steps++;
+    }
+    double exploreSeconds = SecondsSince(t0);
+
+    double cells = (double)cols * rows;
+    // The generator's own visited bitset and 2-bit stack are freed by now.
+    // The robot's stack has kept its peak size.
+    size_t bytes = maze.MemoryBytes() + discovered.MemoryBytes() + robot.visited.MemoryBytes() +
+                   robot.stack.MemoryBytes();
+    // Old layout: 5-bool Cell for grid and known, vector<bool> for
+    // discovered and robot.visited, plus a vector header per row of each,
+    // and a cell pair per step on the robot's stack
+    double oldBytes = cells * (2 * 5 + 2 / 8.0) + 4.0 * rows * sizeof(std::vector<int>) +
+                      (double)(deepest + 1) * sizeof(std::pair<int,int>);
+
+    printf("Maze %dx%d (%.0f cells)\n", cols, rows, cells);
+    printf("  generate: %.2f s (%.1f M cells/s)\n", genSeconds, cells / genSeconds / 1e6);
+    printf("  explore:  %.2f s, %lld steps, %s, path %zu deep at most (%.1f%% of cells)\n",
+           exploreSeconds, steps, done ? "explored everything" : "goal reached",
+           deepest, deepest * 100.0 / cells);
+    printf("  walls %.1f MB, each bitset %.1f MB, robot stack %.1f MB at its deepest\n",
+           maze.MemoryBytes() / 1048576.0, discovered.MemoryBytes() / 1048576.0,
+           robot.stack.MemoryBytes() / 1048576.0);
+    printf("  memory: %.2f bits/cell (%.1f MB), nested vectors: %.1f bits/cell (%.1f MB)\n",
+           bytes * 8.0 / cells, bytes / 1048576.0,
+           oldBytes * 8.0 / cells, oldBytes / 1048576.0);
+    return 0;
+}
+
+// True if every cell is reachable and there are exactly cells - 1
+// passages, i.e. the maze is a spanning tree
+bool isPerfectMaze(const Maze& maze)
+{
+    int w = maze.Cols(), h = maze.Rows();
+    size_t passages = 0;
+    for (int y=0;y<h;y++)
+        for (int x=0;x<w;x++)
+            passages += !maze.RightWall(x,y) + !maze.BottomWall(x,y);
+    if (passages != (size_t)w * h - 1) return false;
+
+    BitGrid seen;
+    seen.Reset(w, h);
+    std::vector<std::pair<int,int>> open = {{0,0}};
+    seen.Set(0, 0);
+    size_t reached = 1;
+    while (!open.empty()) {
+        auto [x,y] = open.back();
+        open.pop_back();
+        auto visit = [&](int nx, int ny) {
+            if (seen.Get(nx,ny)) return;
+            seen.Set(nx,ny);
+            open.push_back({nx,ny});
+            reached++;
+        };
+        if (!maze.TopWall(x,y)) visit(x,y-1);
+        if (!maze.RightWall(x,y)) visit(x+1,y);
+        if (!maze.BottomWall(x,y)) visit(x,y+1);
+        if (!maze.LeftWall(x,y)) visit(x-1,y);
+    }
+    return reached == (size_t)w * h;
+}
+
+// Maze draw calls per frame, immediate vs cached, over a run of the
+// animated generation followed by exploration. The canvas is a render
+// texture, so the caller opens a (hidden) window first.
+int RunDrawBench(int c, int r) {
+    cols = c;
+    rows = r;
+    cellSize = std::max(1, std::min(40, std::min(1600 / cols, 900 / rows)));
+    srand(1);
+
+    Maze maze;
+    BitGrid genVisited, discovered;
+    maze.Reset(cols, rows);
+    genVisited.Reset(cols, rows);
+    discovered.Reset(cols, rows);
+    std::stack<std::pair<int,int>> genStack;
+    genVisited.Set(0, 0);
+    genStack.push({0,0});
+    MazeCanvas canvas;
+    canvas.Load(cols, rows, cellSize);
+
+    int immediateStart = DrawMazeImmediate(maze, nullptr, cellSize);
+    int firstFrame = canvas.Update(maze, nullptr);
+
+    long long frames = 0, total = 0;
+    int most = 0;
+    while (generationStep(maze, genVisited, genStack, &canvas)) {
+        int calls = canvas.Update(maze, nullptr);
+        total += calls;
+        most = std::max(most, calls);
+        frames++;
+    }
+    int immediateExplore = DrawMazeImmediate(maze, &discovered, cellSize);
+    canvas.MarkAll();
+    int fogFrame = canvas.Update(maze, &discovered);
+
+    Robot robot;
+    resetRobot(robot);
+    long long exploreFrames = 0, exploreTotal = 0;
+    int exploreMost = 0;
+    bool done = false;
+    while (!done && !(robot.cellX == cols-1 && robot.cellY == rows-1)) {
+        done = explorationStep(robot, maze, discovered, &canvas);
+        int calls = canvas.Update(maze, &discovered);
+        exploreTotal += calls;
+        exploreMost = std::max(exploreMost, calls);
+        exploreFrames++;
+    }
+    int immediateEnd = DrawMazeImmediate(maze, &discovered, cellSize);
+    canvas.Unload();
+
+    printf("Maze %dx%d, %d px cells: maze draw calls per frame\n", cols, rows, cellSize);
+    printf("  immediate: %d at start, %d when exploring begins, %d at the goal\n",
+           immediateStart, immediateExplore, immediateEnd);
+    printf("  cached:    generating avg %.2f max %d over %lld frames; exploring avg %.2f max %d over %lld frames\n",
+           (double)total / frames, most, frames,
+           (double)exploreTotal / exploreFrames, exploreMost, exploreFrames);
+    printf("             full redraws (first frame, fog down): %d and %d\n", firstFrame, fogFrame);
+    printf("  plus 1 texture blit and 3-5 sprites/text per frame either way\n");
+    return 0;
+}
+
+// Cells per second for the animated step generator and each
+// run-to-completion generator, checking that every result is a perfect maze
+int RunGeneratorBench(int size) {
+    cols = rows = size;
+    double cells = (double)cols * rows;
+    printf("Generators on %dx%d (%.0f cells)\n", cols, rows, cells);
+
+    Maze maze;
+    {
+        srand(1);
+        maze.Reset(cols, rows);
+        BitGrid genVisited;
+        genVisited.Reset(cols, rows);
+        std::stack<std::pair<int,int>> genStack;
+        genVisited.Set(0, 0);
+        genStack.push({0,0});
+        auto t0 = std::chrono::steady_clock::now();
+        while (generationStep(maze, genVisited, genStack)) {}
+        double seconds = SecondsSince(t0);
+        printf("  %-18s %8.3f s %8.2f M cells/s  %s\n", "step (std::stack)", seconds,
+               cells / seconds / 1e6, isPerfectMaze(maze) ? "ok" : "NOT A PERFECT MAZE");
+    }
+
+    for (int g = 0; g < GENERATOR_COUNT; g++) {
+        maze.Reset(cols, rows);
+        auto t0 = std::chrono::steady_clock::now();
+        Generate(maze, (Generator)g, 1);
+        double seconds = SecondsSince(t0);
+        printf("  %-18s %8.3f s %8.2f M cells/s  %s\n", GeneratorName((Generator)g), seconds,
+               cells / seconds / 1e6, isPerfectMaze(maze) ? "ok" : "NOT A PERFECT MAZE");
+    }
+    return 0;
+}
+
+// Wall test for the endless maze
+bool streamWall(MazeStream& maze, int x, long long y, int dir)
+{
+    if (dir == TOP) return maze.TopWall(x,y);
+    if (dir == RIGHT) return maze.RightWall(x,y);
+    if (dir == BOTTOM) return maze.BottomWall(x,y);
+    return maze.LeftWall(x,y);
+}
+
+// Endless maze: the robot walks down a maze streamed row by row while the
+// view scrolls with it. The stack robot would need visited flags for every
+// row it ever saw, so this one keeps its right hand on the wall instead,
+// which walks a perfect maze depth first in O(1) memory.
+int RunStream(int width) {
+    cols = std::max(2, width);
+    cellSize = std::max(4, std::min(40, 1600 / cols));
+    int viewRows = 900 / cellSize;
+
+    InitWindow(cols * cellSize, viewRows * cellSize,
+               "Endless Maze Exploration");
+    SetTargetFPS(60);
+
+    // Keep a few rows beyond the view; anything older is dropped and
+    // rebuilt from a checkpoint if the robot ever walks back up to it
+    MazeStream maze;
+    maze.Reset(cols, (uint64_t)time(NULL), viewRows + 4, 256);
+
+    int cellX = 0;
+    long long cellY = 0;
+    int heading = BOTTOM;
+    // Pixel positions relative to the top of the maze; doubles so they
+    // stay exact far down
+    double robotX = cellSize/2.0, robotY = cellSize/2.0;
+    double scroll = 0; // first visible row, fractional
+
+    float timer = 0;
+    while (!WindowShouldClose()) {
+
+        // ---------- UPDATE ----------
+        timer += GetFrameTime();
+        if (timer > 0.05f) {
+            // Right-hand rule: try right, straight, left, then turn back
+            for (int turn : {1, 0, 3, 2}) {
+                int dir = (heading + turn) % 4;
+                if (streamWall(maze, cellX, cellY, dir)) continue;
+                heading = dir;
+                cellX += (dir == RIGHT) - (dir == LEFT);
+                cellY += (dir == BOTTOM) - (dir == TOP);
+                break;
+            }
+            timer = 0;
+        }
+
+        robotX += (cellX * cellSize + cellSize/2.0 - robotX) * 0.2;
+        robotY += (cellY * cellSize + cellSize/2.0 - robotY) * 0.2;
+        // Keep the robot a third of the way down the view
+        double scrollTarget = std::max(0.0, robotY / cellSize - viewRows / 3.0);
+        scroll += (scrollTarget - scroll) * 0.1;
+
+        // ---------- DRAW ----------
+        BeginDrawing();
+        ClearBackground(BLACK);
+
+        long long first = (long long)scroll;
+        for (long long y = first; y <= first + viewRows; y++) {
+            int py = (int)((y - scroll) * cellSize);
+            if (y == 0) DrawLine(0,py,cols*cellSize,py,WHITE);
+            DrawLine(0,py,0,py+cellSize,WHITE);
+            for (int x=0;x<cols;x++) {
+                int px = x * cellSize;
+                if (maze.RightWall(x,y)) DrawLine(px+cellSize,py,
+                                                  px+cellSize,py+cellSize,WHITE);
+                if (maze.BottomWall(x,y)) DrawLine(px,py+cellSize,
+                                                   px+cellSize,py+cellSize,WHITE);
+            }
+        }
+
+        DrawCircleV({(float)robotX, (float)(robotY - scroll * cellSize)},
+                    cellSize/4, ORANGE);
+
+        DrawText(TextFormat("row %lld  generated %lld  %.1f KB",
+                            cellY, maze.RowsGenerated(), maze.MemoryBytes() / 1024.0),
+                 10,10,20,YELLOW);
+
+        EndDrawing();
+    }
+
+    CloseWindow();
+    return 0;
+}
+
+// Stream a tall maze headless: rows/s, memory, and checks that rows
+// rebuilt from checkpoints match the streamed ones and that the first
+// rows contain no loops
+int RunStreamBench(int width, int rowCount) {
+    MazeStream maze;
+    maze.Reset(width, 1, 64, 256);
+
+    const int checkRows = std::min(rowCount, 512);
+    std::vector<uint32_t> parent((size_t)width * checkRows);
+    for (size_t k = 0; k < parent.size(); k++) parent[k] = (uint32_t)k;
+    auto find = [&](uint32_t a) {
+        while (parent[a] != a) {
+            parent[a] = parent[parent[a]];
+            a = parent[a];
+        }
+        return a;
+    };
+    bool loopFree = true;
+
+    std::vector<uint64_t> hashes(rowCount);
+    int words = (2 * width + 63) / 64;
+    double streamSeconds = 0;
+    for (int y = 0; y < rowCount; y++) {
+        auto t0 = std::chrono::steady_clock::now();
+        const uint64_t* row = maze.Row(y);
+        streamSeconds += SecondsSince(t0);
+
+        uint64_t hash = 1469598103934665603ull;
+        for (int k = 0; k < words; k++) hash = (hash ^ row[k]) * 1099511628211ull;
+        hashes[y] = hash;
+
+        // Every passage inside the checked rows must join two separate parts
+        if (y < checkRows) {
+            for (int x = 0; x < width; x++) {
+                uint32_t a = (uint32_t)((size_t)y * width + x);
+                if (!maze.RightWall(x,y)) {
+                    uint32_t ra = find(a), rb = find(a + 1);
+                    if (ra == rb) loopFree = false;
+                    parent[ra] = rb;
+                }
+                if (y + 1 < checkRows && !maze.BottomWall(x,y)) {
+                    uint32_t ra = find(a), rb = find(a + width);
+                    if (ra == rb) loopFree = false;
+                    parent[ra] = rb;
+                }
+            }
+        }
+    }
+
+    // Rebuild random rows from their checkpoints
+    srand(1);
+    int samples = 1000, mismatches = 0;
+    std::vector<uint64_t> rebuilt;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int k = 0; k < samples; k++) {
+        int y = rand() % rowCount;
+        maze.RegenerateRow(y, rebuilt);
+        uint64_t hash = 1469598103934665603ull;
+        for (int w = 0; w < words; w++) hash = (hash ^ rebuilt[w]) * 1099511628211ull;
+        mismatches += hash != hashes[y];
+    }
+    double rebuildSeconds = SecondsSince(t0);
+
+    double cells = (double)width * rowCount;
+    printf("Eller stream %d wide, %d rows (%.0f cells)\n", width, rowCount, cells);
+    printf("  stream:  %.3f s, %.0f rows/s, %.1f M cells/s\n",
+           streamSeconds, rowCount / streamSeconds, cells / streamSeconds / 1e6);
+    printf("  rebuild: %.1f us per row from checkpoints, %d/%d mismatches\n",
+           rebuildSeconds / samples * 1e6, mismatches, samples);
+    printf("  first %d rows %s\n", checkRows, loopFree ? "loop free" : "CONTAIN A LOOP");
+    printf("  memory: %.1f KB, a packed %dx%d maze would be %.1f MB\n",
+           maze.MemoryBytes() / 1024.0, width, rowCount, cells * 2 / 8 / 1048576.0);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0)
+        return RunBench(argc > 2 ? atoi(argv[2]) : 16384);
+    if (argc > 1 && strcmp(argv[1], "--bench-gen") == 0)
+        return RunGeneratorBench(argc > 2 ? atoi(argv[2]) : 2048);
+    if (argc > 1 && strcmp(argv[1], "--bench-draw") == 0) {
+        SetConfigFlags(FLAG_WINDOW_HIDDEN);
+        InitWindow(1600, 900, "Maze draw benchmark");
+        int result;
+        if (argc > 3) {
+            result = RunDrawBench(atoi(argv[2]), atoi(argv[3]));
+        } else {
+            RunDrawBench(30, 15);
+            result = RunDrawBench(1000, 1000);
+        }
+        CloseWindow();
+        return result;
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-stream") == 0)
+        return RunStreamBench(argc > 2 ? atoi(argv[2]) : 4096,
+                              argc > 3 ? atoi(argv[3]) : 16384);
+    if (argc > 1 && strcmp(argv[1], "--stream") == 0)
+        return RunStream(argc > 2 ? atoi(argv[2]) : 40);
+
+    // Optional maze size: cols rows
+    if (argc > 2) {
+        cols = std::max(2, atoi(argv[1]));
+        rows = std::max(2, atoi(argv[2]));
+    }
+    // Shrink cells so big mazes still fit on screen
+    cellSize = std::max(1, std::min(40, std::min(1600 / cols, 900 / rows)));
 
     srand(time(NULL));
 
@@ -203,50 +605,46 @@ int main() {
                "Autonomous Maze Exploration");
     SetTargetFPS(60);
 
-    // Maze grid and robot knowledge
-    std::vector<std::vector<Cell>> grid(rows, std::vector<Cell>(cols));
-    std::vector<std::vector<Cell>> known(rows, std::vector<Cell>(cols));
-    std::vector<std::vector<bool>> discovered(rows,
-        std::vector<bool>(cols, false));
+    // Maze walls, generation bookkeeping and robot knowledge
+    Maze maze;
+    BitGrid genVisited;
+    BitGrid discovered;
+    maze.Reset(cols, rows);
+    genVisited.Reset(cols, rows);
+    discovered.Reset(cols, rows);
 
     // Stack for maze generation
     std::stack<std::pair<int,int>> genStack;
-    int gx = 0, gy = 0;
-    grid[0][0].visited = true;
+    genVisited.Set(0, 0);
     genStack.push({0,0});
 
     Robot robot;
 
+    // Walls and fog, redrawn only where they change
+    MazeCanvas canvas;
+    canvas.Load(cols, rows, cellSize);
+
     while (!WindowShouldClose()) {
 
         // ---------- UPDATE ----------
         if (state == GENERATING) {
+            // 1/2/3 skip the animation: backtracker, Wilson, Kruskal
+            int instant = IsKeyPressed(KEY_ONE) ? GEN_BACKTRACKER :
+                          IsKeyPressed(KEY_TWO) ? GEN_WILSON :
+                          IsKeyPressed(KEY_THREE) ? GEN_KRUSKAL : -1;
+            if (instant >= 0) {
+                maze.Reset(cols, rows);
+                Generate(maze, (Generator)instant, (uint32_t)rand());
+                genStack = {};
+                canvas.MarkAll();
+            }
+
             // Maze generation using recursive backtracking
-            if (!genStack.empty()) {
-                auto [x,y] = genStack.top();
-                int nx, ny;
-                Direction dir;
-
-                if (getUnvisitedNeighbor(x,y,grid,nx,ny,dir)) {
-                    grid[ny][nx].visited = true;
-                    removeWall(grid[y][x], grid[ny][nx], dir);
-                    genStack.push({nx,ny});
-                } else {
-                    genStack.pop();
-                }
-            } else {
+            if (!generationStep(maze, genVisited, genStack, &canvas)) {
                 // Maze generation finished → initialize robot
-                robot.cellX = 0;
-                robot.cellY = 0;
-                robot.position = {cellSize/2.0f, cellSize/2.0f};
-                robot.target = robot.position;
-                robot.visited =
-                    std::vector<std::vector<bool>>(rows,
-                        std::vector<bool>(cols,false));
-                robot.visited[0][0] = true;
-                robot.stack.push({0,0});
-
+                resetRobot(robot);
                 state = EXPLORING;
+                canvas.MarkAll(); // fog comes down
             }
         }
 
@@ -257,8 +655,7 @@ int main() {
             timer += GetFrameTime();
 
             if (timer > 0.05f) {
-                bool done = explorationStep(robot, grid,
-                                            known, discovered);
+                explorationStep(robot, maze, discovered, &canvas);
                 // Check if robot reached goal
                 if (robot.cellX == cols-1 &&
                     robot.cellY == rows-1) {
@@ -276,35 +673,13 @@ int main() {
         }
 
         // ---------- DRAW ----------
+        int drawCalls = canvas.Update(maze, state == GENERATING ? nullptr : &discovered);
+
         BeginDrawing();
         ClearBackground(BLACK);
 
-        // Draw maze cells
-        for (int y=0;y<rows;y++) {
-            for (int x=0;x<cols;x++) {
-
-                int px = x * cellSize;
-                int py = y * cellSize;
-
-                Cell& c = grid[y][x];
-
-                // Draw cell walls
-                if (c.topWall) DrawLine(px,py,px+cellSize,py,WHITE);
-                if (c.rightWall) DrawLine(px+cellSize,py,
-                                          px+cellSize,py+cellSize,WHITE);
-                if (c.bottomWall) DrawLine(px,py+cellSize,
-                                           px+cellSize,py+cellSize,WHITE);
-                if (c.leftWall) DrawLine(px,py,
-                                         px,py+cellSize,WHITE);
-
-                // Darken unexplored cells
-                if (state != GENERATING &&
-                    !discovered[y][x]) {
-                    DrawRectangle(px,py,cellSize,cellSize,
-                                  Fade(BLACK,0.6f));
-                }
-            }
-        }
+        // Maze walls and fog
+        canvas.Draw();
 
         // Draw start (green) and end (red) cells
         DrawRectangle(2,2,cellSize-4,cellSize-4,GREEN);
@@ -317,15 +692,23 @@ int main() {
             DrawCircleV(robot.position,
                         cellSize/4, ORANGE);
 
+        if (state == GENERATING)
+            DrawText("1 backtracker  2 Wilson  3 Kruskal: generate at once",
+                     10,10,20,YELLOW);
+
         // Display message when goal is reached
         if (state == FINISHED) {
             DrawText("Goal Reached",
                      20,20,30,YELLOW);
         }
 
+        DrawText(TextFormat("%d maze draw calls", drawCalls),
+                 10,rows*cellSize-24,20,YELLOW);
+
         EndDrawing();
     }
 
+    canvas.Unload();
     CloseWindow();
     return 0;
 }
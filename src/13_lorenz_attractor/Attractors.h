@@ -0,0 +1,160 @@
+#pragma once
+#include <cmath>
+
+// Strange-attractor right-hand sides and integrators.
+// Every system is a small functor and every integrator a template, so
+// each (system, integrator) pair compiles to its own fully inlined kernel.
+// The run-time choice of system only happens once per call, in the
+// switch inside StepPoint / AdvanceBlocks.
+
+// The kernels only vectorise once the functor is inlined into the lane
+// loop; at -O2 gcc gives up on the larger systems without a nudge.
+#if defined(_MSC_VER)
+#define ATTRACTOR_INLINE __forceinline
+#else
+#define ATTRACTOR_INLINE inline __attribute__((always_inline))
+#endif
+
+enum AttractorKind { LORENZ, ROSSLER, AIZAWA, THOMAS, HALVORSEN, ATTRACTOR_COUNT };
+
+// Up to three tunable parameters; each system uses the ones it needs
+struct AttractorParams {
+    float a, b, c;
+};
+
+struct Lorenz {
+    float a, b, c;
+    ATTRACTOR_INLINE void operator()(float x, float y, float z, float& dx, float& dy, float& dz) const {
+        dx = a * (y - x);
+        dy = x * (b - z) - y;
+        dz = x * y - c * z;
+    }
+};
+
+struct Rossler {
+    float a, b, c;
+    ATTRACTOR_INLINE void operator()(float x, float y, float z, float& dx, float& dy, float& dz) const {
+        dx = -y - z;
+        dy = x + a * y;
+        dz = b + z * (x - c);
+    }
+};
+
+struct Aizawa {
+    float a, b, c;   // d, e, f fixed at their usual values
+    ATTRACTOR_INLINE void operator()(float x, float y, float z, float& dx, float& dy, float& dz) const {
+        const float d = 3.5f, e = 0.25f, f = 0.1f;
+        dx = (z - b) * x - d * y;
+        dy = d * x + (z - b) * y;
+        dz = c + a * z - z * z * z / 3.0f - (x * x + y * y) * (1.0f + e * z) + f * z * x * x * x;
+    }
+};
+
+struct Thomas {
+    float a, b, c;   // only b is used
+    ATTRACTOR_INLINE void operator()(float x, float y, float z, float& dx, float& dy, float& dz) const {
+        dx = sinf(y) - b * x;
+        dy = sinf(z) - b * y;
+        dz = sinf(x) - b * z;
+    }
+};
+
+struct Halvorsen {
+    float a, b, c;   // only a is used
+    ATTRACTOR_INLINE void operator()(float x, float y, float z, float& dx, float& dy, float& dz) const {
+        dx = -a * x - 4.0f * y - 4.0f * z - y * y;
+        dy = -a * y - 4.0f * z - 4.0f * x - z * z;
+        dz = -a * z - 4.0f * x - 4.0f * y - x * x;
+    }
+};
+
+// Per-system defaults: parameters, start point, time step, and the scale
+// that brings the attractor to roughly Lorenz size for the shared camera
+struct AttractorInfo {
+    const char* name;
+    AttractorParams params;
+    float x0, y0, z0;
+    float dt;
+    float scale;
+};
+
+inline const AttractorInfo& GetAttractorInfo(AttractorKind kind) {
+    static const AttractorInfo info[ATTRACTOR_COUNT] = {
+        {"Lorenz",    {10.0f, 28.0f, 8.0f / 3.0f}, 0.01f, 0.0f, 0.0f, 0.01f,  1.0f},
+        {"Rossler",   {0.2f, 0.2f, 5.7f},          0.1f,  0.0f, 0.0f, 0.02f,  2.0f},
+        {"Aizawa",    {0.95f, 0.7f, 0.6f},         0.1f,  0.0f, 0.0f, 0.01f,  15.0f},
+        {"Thomas",    {0.0f, 0.208186f, 0.0f},     0.1f,  0.0f, 0.0f, 0.05f,  8.0f},
+        {"Halvorsen", {1.89f, 0.0f, 0.0f},         -1.48f, -1.51f, 2.04f, 0.005f, 2.5f},
+    };
+    return info[kind];
+}
+
+struct Euler {
+    template <class F>
+    ATTRACTOR_INLINE static void Step(const F& f, float& x, float& y, float& z, float dt) {
+        float dx, dy, dz;
+        f(x, y, z, dx, dy, dz);
+        x += dx * dt; y += dy * dt; z += dz * dt;
+    }
+};
+
+struct RK4 {
+    template <class F>
+    ATTRACTOR_INLINE static void Step(const F& f, float& x, float& y, float& z, float dt) {
+        const float h = 0.5f * dt;
+        float k1x, k1y, k1z, k2x, k2y, k2z, k3x, k3y, k3z, k4x, k4y, k4z;
+        f(x, y, z, k1x, k1y, k1z);
+        f(x + h * k1x, y + h * k1y, z + h * k1z, k2x, k2y, k2z);
+        f(x + h * k2x, y + h * k2y, z + h * k2z, k3x, k3y, k3z);
+        f(x + dt * k3x, y + dt * k3y, z + dt * k3z, k4x, k4y, k4z);
+        const float sixth = dt / 6.0f;
+        x += sixth * (k1x + 2.0f * k2x + 2.0f * k3x + k4x);
+        y += sixth * (k1y + 2.0f * k2y + 2.0f * k3y + k4y);
+        z += sixth * (k1z + 2.0f * k2z + 2.0f * k3z + k4z);
+    }
+};
+
+// Advance `blocks` blocks of LANES trajectories stored as SoA arrays.
+// The fixed lane count lets -O2 vectorise the inner loop.
+template <class System, class Integrator, int LANES>
+void AdvanceBlocksT(const System& f, float* __restrict x, float* __restrict y, float* __restrict z,
+                    int blocks, int steps, float dt) {
+    for (int blk = 0; blk < blocks; blk++) {
+        float* bx = x + blk * LANES;
+        float* by = y + blk * LANES;
+        float* bz = z + blk * LANES;
+        for (int s = 0; s < steps; s++) {
+            for (int l = 0; l < LANES; l++) {
+                float px = bx[l], py = by[l], pz = bz[l];
+                Integrator::Step(f, px, py, pz, dt);
+                bx[l] = px; by[l] = py; bz[l] = pz;
+            }
+        }
+    }
+}
+
+template <class Integrator, int LANES>
+void AdvanceBlocks(AttractorKind kind, const AttractorParams& p,
+                   float* x, float* y, float* z, int blocks, int steps, float dt) {
+    switch (kind) {
+        case LORENZ:    AdvanceBlocksT<Lorenz, Integrator, LANES>({p.a, p.b, p.c}, x, y, z, blocks, steps, dt); break;
+        case ROSSLER:   AdvanceBlocksT<Rossler, Integrator, LANES>({p.a, p.b, p.c}, x, y, z, blocks, steps, dt); break;
+        case AIZAWA:    AdvanceBlocksT<Aizawa, Integrator, LANES>({p.a, p.b, p.c}, x, y, z, blocks, steps, dt); break;
+        case THOMAS:    AdvanceBlocksT<Thomas, Integrator, LANES>({p.a, p.b, p.c}, x, y, z, blocks, steps, dt); break;
+        case HALVORSEN: AdvanceBlocksT<Halvorsen, Integrator, LANES>({p.a, p.b, p.c}, x, y, z, blocks, steps, dt); break;
+        default: break;
+    }
+}
+
+// Single trajectory, used by the trail
+template <class Integrator>
+void StepPoint(AttractorKind kind, const AttractorParams& p, float& x, float& y, float& z, float dt) {
+    switch (kind) {
+        case LORENZ:    Integrator::Step(Lorenz{p.a, p.b, p.c}, x, y, z, dt); break;
+        case ROSSLER:   Integrator::Step(Rossler{p.a, p.b, p.c}, x, y, z, dt); break;
+        case AIZAWA:    Integrator::Step(Aizawa{p.a, p.b, p.c}, x, y, z, dt); break;
+        case THOMAS:    Integrator::Step(Thomas{p.a, p.b, p.c}, x, y, z, dt); break;
+        case HALVORSEN: Integrator::Step(Halvorsen{p.a, p.b, p.c}, x, y, z, dt); break;
+        default: break;
+    }
+}
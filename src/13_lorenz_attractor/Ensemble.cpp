@@ -0,0 +1,57 @@
+#include "Ensemble.h"
+#include "ThreadPool.h"
+#include "rlgl.h"
+#include <random>
+
+void Ensemble::Reset(int n, Vector3 origin, float spread, unsigned seed) {
+    count = n;
+    int padded = (n + LANES - 1) / LANES * LANES;
+    x.assign(padded, origin.x); y.assign(padded, origin.y); z.assign(padded, origin.z);
+    colors.resize(n);
+
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> jitter(-0.5f * spread, 0.5f * spread);
+    for (int i = 0; i < n; i++) {
+        x[i] += jitter(gen);
+        y[i] += jitter(gen);
+        z[i] += jitter(gen);
+        colors[i] = ColorFromHSV(360.0f * i / n, 0.8f, 1.0f);
+    }
+    px = x; py = y; pz = z;
+}
+
+void Ensemble::Step(AttractorKind kind, const AttractorParams& p, float dt, int steps, ThreadPool* pool) {
+    px = x; py = y; pz = z;
+
+    int blocks = (int)x.size() / LANES;
+    auto work = [&](int begin, int end, int) {
+        // Each block stays in registers for all sub-steps before moving on
+        AdvanceBlocks<RK4, LANES>(kind, p, &x[begin * LANES], &y[begin * LANES], &z[begin * LANES],
+                                  end - begin, steps, dt);
+    };
+
+    if (pool) pool->ParallelFor(blocks, work);
+    else work(0, blocks, 0);
+}
+
+Vector3 Ensemble::Centroid() const {
+    if (count == 0) return {0.0f, 0.0f, 0.0f};
+    double sx = 0.0, sy = 0.0, sz = 0.0;
+    for (int i = 0; i < count; i++) { sx += x[i]; sy += y[i]; sz += z[i]; }
+    return {(float)(sx / count), (float)(sy / count), (float)(sz / count)};
+}
+
+void Ensemble::Draw(float scale) const {
+    const int CHUNK = 1024;
+    for (int start = 0; start < count; start += CHUNK) {
+        int end = (start + CHUNK < count) ? start + CHUNK : count;
+        rlCheckRenderBatchLimit(2 * (end - start));
+        rlBegin(RL_LINES);
+        for (int i = start; i < end; i++) {
+            rlColor4ub(colors[i].r, colors[i].g, colors[i].b, colors[i].a);
+            rlVertex3f(px[i] * scale, py[i] * scale, pz[i] * scale);
+            rlVertex3f(x[i] * scale, y[i] * scale, z[i] * scale);
+        }
+        rlEnd();
+    }
+}
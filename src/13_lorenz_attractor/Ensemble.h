@@ -0,0 +1,34 @@
+#pragma once
+#include "raylib.h"
+#include "Attractors.h"
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+// Many trajectories of one attractor advanced together with RK4.
+// State is stored as structure-of-arrays and padded to a multiple of
+// LANES so the inner kernel runs on fixed-width blocks the compiler can
+// turn into SIMD; a worker pool splits the blocks into chunks.
+class Ensemble {
+public:
+    static const int LANES = 8;
+
+    // count trajectories starting in a cube of side `spread` around origin
+    void Reset(int count, Vector3 origin, float spread, unsigned seed);
+
+    // Advance every trajectory by `steps` RK4 steps of size dt
+    void Step(AttractorKind kind, const AttractorParams& p, float dt, int steps, ThreadPool* pool);
+
+    int Size() const { return count; }
+    Vector3 Centroid() const;
+
+    // Each trajectory as a short streak from its previous head position
+    void Draw(float scale) const;
+
+private:
+    int count = 0;
+    std::vector<float> x, y, z;       // current heads (padded)
+    std::vector<float> px, py, pz;    // heads before the last Step()
+    std::vector<Color> colors;        // fixed colour per trajectory
+};
@@ -0,0 +1,55 @@
+#include "TrailBuffer.h"
+
+TrailBuffer::TrailBuffer(size_t capacity) : data(capacity > 0 ? capacity : 1) {}
+
+void TrailBuffer::Push(const Point3D& p) {
+    size_t cap = data.size();
+    if (count < cap) {
+        size_t k = head + count;
+        if (k >= cap) k -= cap;
+        data[k] = p;
+        count++;
+    } else {
+        // Overwrite the oldest slot and move head forward
+        const Vector3& old = data[head].pos;
+        sumX -= old.x; sumY -= old.y; sumZ -= old.z;
+        data[head] = p;
+        head = (head + 1 == cap) ? 0 : head + 1;
+
+        if (++evictions >= cap) {
+            sumX += p.pos.x; sumY += p.pos.y; sumZ += p.pos.z;
+            Resync();
+            return;
+        }
+    }
+    sumX += p.pos.x; sumY += p.pos.y; sumZ += p.pos.z;
+}
+
+void TrailBuffer::Clear() {
+    head = count = evictions = 0;
+    sumX = sumY = sumZ = 0.0;
+}
+
+Vector3 TrailBuffer::Centroid() const {
+    if (count == 0) return {0.0f, 0.0f, 0.0f};
+    double inv = 1.0 / count;
+    return {(float)(sumX * inv), (float)(sumY * inv), (float)(sumZ * inv)};
+}
+
+// Kahan-compensated recompute of the running sums
+void TrailBuffer::Resync() {
+    double s[3] = {0.0, 0.0, 0.0};
+    double c[3] = {0.0, 0.0, 0.0};
+    for (size_t i = 0; i < count; i++) {
+        const Vector3& v = (*this)[i].pos;
+        const double vals[3] = {v.x, v.y, v.z};
+        for (int a = 0; a < 3; a++) {
+            double y = vals[a] - c[a];
+            double t = s[a] + y;
+            c[a] = (t - s[a]) - y;
+            s[a] = t;
+        }
+    }
+    sumX = s[0]; sumY = s[1]; sumZ = s[2];
+    evictions = 0;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "raylib.h"
+#include <vector>
+#include <cstddef>
+
+struct Point3D {
+    Vector3 pos;
+    float hue;
+};
+
+// Fixed-capacity trail stored in one contiguous ring.
+// A running sum of all positions is updated on push/evict so the centroid
+// costs O(1); the sum is recomputed with Kahan summation once every
+// `capacity` evictions to stop rounding drift from building up.
+class TrailBuffer {
+public:
+    explicit TrailBuffer(size_t capacity);
+
+    void Push(const Point3D& p);   // evicts the oldest point when full
+    void Clear();
+
+    size_t Size() const { return count; }
+    size_t Capacity() const { return data.size(); }
+    bool Empty() const { return count == 0; }
+
+    // i = 0 is the oldest point, Size() - 1 the newest
+    const Point3D& operator[](size_t i) const {
+        size_t k = head + i;
+        if (k >= data.size()) k -= data.size();
+        return data[k];
+    }
+
+    Vector3 Centroid() const;
+
+private:
+    std::vector<Point3D> data;
+    size_t head = 0;    // slot of the oldest point
+    size_t count = 0;
+    double sumX = 0.0, sumY = 0.0, sumZ = 0.0;
+    size_t evictions = 0;
+
+    void Resync();
+};
@@ -0,0 +1,63 @@
+#include "TrailRenderer.h"
+#include "rlgl.h"
+#include <cmath>
+#include <cstdint>
+
+TrailRenderer::TrailRenderer() : lut(FADE_STEPS * HUE_STEPS) {
+    for (int f = 0; f < FADE_STEPS; f++) {
+        float value = (f + 1) / (float)FADE_STEPS;
+        for (int h = 0; h < HUE_STEPS; h++)
+            lut[f * HUE_STEPS + h] = ColorFromHSV((float)h, 1.0f, value);
+    }
+}
+
+void TrailRenderer::Draw(const TrailBuffer& trail, float hueOffset) const {
+    size_t n = trail.Size();
+    if (n < 2) return;
+
+    // 16.16 fixed-point steps along the trail: i / n scaled to table size
+    const uint64_t hueStep  = ((uint64_t)HUE_STEPS << 16) / n;
+    const uint64_t fadeStep = ((uint64_t)FADE_STEPS << 16) / n;
+    const int hueBase = (int)hueOffset % HUE_STEPS;
+
+    auto colorAt = [&](size_t i) {
+        int h = hueBase + (int)((i * hueStep) >> 16);
+        if (h >= HUE_STEPS) h -= HUE_STEPS;
+        int f = (int)((i * fadeStep) >> 16);
+        if (f >= FADE_STEPS) f = FADE_STEPS - 1;
+        return lut[f * HUE_STEPS + h];
+    };
+
+    // Submit in chunks so a chunk never straddles a render batch flush
+    const size_t CHUNK = 1024;
+    Vector3 prev = trail[0].pos;
+    Color prevCol = colorAt(0);
+
+    for (size_t start = 1; start < n; start += CHUNK) {
+        size_t end = (start + CHUNK < n) ? start + CHUNK : n;
+        rlCheckRenderBatchLimit((int)(2 * (end - start)));
+        rlBegin(RL_LINES);
+        for (size_t i = start; i < end; i++) {
+            Vector3 p = trail[i].pos;
+            Color col = colorAt(i);
+            rlColor4ub(prevCol.r, prevCol.g, prevCol.b, prevCol.a);
+            rlVertex3f(prev.x, prev.y, prev.z);
+            rlColor4ub(col.r, col.g, col.b, col.a);
+            rlVertex3f(p.x, p.y, p.z);
+            prev = p;
+            prevCol = col;
+        }
+        rlEnd();
+    }
+}
+
+void DrawTrailPerSegment(const TrailBuffer& trail, float hueOffset) {
+    size_t n = trail.Size();
+    for (size_t i = 1; i < n; i++) {
+        // Color gradient along trail with fading brightness
+        float t = (float)i / n;      // 0 oldest -> 1 newest
+        float hue = fmod(hueOffset + t * 360.0f, 360.0f);
+        Color col = ColorFromHSV(hue, 1.0f, t); // fade brightness
+        DrawLine3D(trail[i-1].pos, trail[i].pos, col);
+    }
+}
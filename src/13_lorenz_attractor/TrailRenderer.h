@@ -0,0 +1,30 @@
+#pragma once
+#include "raylib.h"
+#include "TrailBuffer.h"
+#include <vector>
+
+// Draws a TrailBuffer as one batched, per-vertex coloured line list.
+// Colours come from a precomputed hue x brightness table, so animating
+// the hue only shifts the table index instead of calling ColorFromHSV
+// for every segment.
+//
+// Vertices still go through rlgl's batch each frame rather than a
+// persistent vertex buffer with the hue offset as a shader uniform:
+// rlDrawVertexArray only draws triangles, and the colour of a vertex
+// depends on its age, which changes with every point pushed.
+class TrailRenderer {
+public:
+    static const int HUE_STEPS = 360;   // 1 degree per entry
+    static const int FADE_STEPS = 64;   // brightness levels along the trail
+
+    TrailRenderer();
+
+    // hueOffset in degrees: oldest point gets hueOffset, newest hueOffset + 360
+    void Draw(const TrailBuffer& trail, float hueOffset) const;
+
+private:
+    std::vector<Color> lut;   // FADE_STEPS rows of HUE_STEPS colours
+};
+
+// Reference path: one DrawLine3D and one ColorFromHSV per segment
+void DrawTrailPerSegment(const TrailBuffer& trail, float hueOffset);
@@ -1,19 +1,217 @@
 #include "raylib.h"
-#include <deque>
+#include "rlgl.h"
+#include <algorithm>
+#include <chrono>
 #include <cmath>
-
-struct Point3D {
-    Vector3 pos;
-    float hue;
-};
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <vector>
+#include <thread>
+#include "TrailBuffer.h"
+#include "TrailRenderer.h"
+#include "Ensemble.h"
+#include "ThreadPool.h"
+#include "Attractors.h"
 
 // Linear interpolation
 float Lerp(float a, float b, float t) {
     return a + t * (b - a);
 }
 
-int main() {
-    InitWindow(800, 600, "3D Lorenz Attractor");
+// Fill a trail with `count` Euler steps of the Lorenz system
+void FillLorenzTrail(TrailBuffer& trail, size_t count) {
+    float x = 0.01f, y = 0.0f, z = 0.0f;
+    const float a = 10.0f, b = 28.0f, c = 8.0f / 3.0f, dt = 0.01f;
+    for (size_t i = 0; i < count; i++) {
+        float dx = a * (y - x) * dt;
+        float dy = (x * (b - z) - y) * dt;
+        float dz = (x * y - c * z) * dt;
+        x += dx; y += dy; z += dz;
+        trail.Push({{x, y, z}, 0.0f});
+    }
+}
+
+// CPU time to submit the trail: per-segment DrawLine3D vs batched renderer
+int RunTrailBenchmark() {
+    InitWindow(800, 600, "Lorenz trail benchmark");
+
+    Camera3D camera = {};
+    camera.position = {50.0f, 50.0f, 50.0f};
+    camera.target = {0.0f, 0.0f, 25.0f};
+    camera.up = {0.0f, 1.0f, 0.0f};
+    camera.fovy = 45.0f;
+
+    TrailRenderer renderer;
+    const int frames = 10;
+
+    printf("segments   per-segment ms   batched ms   speedup\n");
+    for (size_t segments : {2000u, 100000u, 1000000u}) {
+        TrailBuffer trail(segments + 1);
+        FillLorenzTrail(trail, segments + 1);
+
+        double ms[2] = {0.0, 0.0};
+        for (int path = 0; path < 2; path++) {
+            for (int f = 0; f < frames; f++) {
+                BeginDrawing();
+                ClearBackground(BLACK);
+                BeginMode3D(camera);
+                double start = GetTime();
+                if (path == 0) DrawTrailPerSegment(trail, 120.0f);
+                else renderer.Draw(trail, 120.0f);
+                rlDrawRenderBatchActive();
+                ms[path] += (GetTime() - start) * 1000.0 / frames;
+                EndMode3D();
+                EndDrawing();
+            }
+        }
+        printf("%8zu   %14.3f   %10.3f   %6.1fx\n", segments, ms[0], ms[1], ms[0] / ms[1]);
+    }
+
+    CloseWindow();
+    return 0;
+}
+
+// Wall-clock seconds since start. The headless benchmarks run without a
+// window, and raylib's GetTime() reads 0 until one is open.
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Headless ensemble throughput: trajectory-steps per second for 1..N threads
+int RunEnsembleBenchmark(int count, int maxThreads) {
+    Ensemble ensemble;
+    const AttractorInfo& info = GetAttractorInfo(LORENZ);
+    const int steps = 100;
+
+    std::vector<int> threadCounts;
+    for (int t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    printf("%d trajectories, RK4, %d steps per run\n", count, steps);
+    printf("threads   Msteps/s   per core   speedup\n");
+    double base = 0.0;
+    for (int t : threadCounts) {
+        ThreadPool pool(t);
+        ensemble.Reset(count, {info.x0, info.y0, info.z0}, 0.01f, 1234);
+        ensemble.Step(LORENZ, info.params, info.dt, 1, &pool);   // warm up
+
+        auto start = std::chrono::steady_clock::now();
+        ensemble.Step(LORENZ, info.params, info.dt, steps, &pool);
+        double rate = (double)count * steps / SecondsSince(start) / 1e6;
+        if (t == 1) base = rate;
+        printf("%7d   %8.1f   %8.1f   %6.2fx\n", t, rate, rate / t, rate / base);
+    }
+    return 0;
+}
+
+// The Lorenz RK4 block kernel written out by hand, as the baseline the
+// templated AdvanceBlocks<RK4> path has to match
+static void HandWrittenLorenzRk4(float* __restrict x, float* __restrict y, float* __restrict z,
+                                 int blocks, int steps, float a, float b, float c, float dt) {
+    const float h = 0.5f * dt;
+    const float sixth = dt / 6.0f;
+    for (int blk = 0; blk < blocks; blk++) {
+        float* bx = x + blk * Ensemble::LANES;
+        float* by = y + blk * Ensemble::LANES;
+        float* bz = z + blk * Ensemble::LANES;
+        for (int s = 0; s < steps; s++) {
+            for (int l = 0; l < Ensemble::LANES; l++) {
+                float x0 = bx[l], y0 = by[l], z0 = bz[l];
+                float k1x = a * (y0 - x0), k1y = x0 * (b - z0) - y0, k1z = x0 * y0 - c * z0;
+                float x1 = x0 + h * k1x, y1 = y0 + h * k1y, z1 = z0 + h * k1z;
+                float k2x = a * (y1 - x1), k2y = x1 * (b - z1) - y1, k2z = x1 * y1 - c * z1;
+                float x2 = x0 + h * k2x, y2 = y0 + h * k2y, z2 = z0 + h * k2z;
+                float k3x = a * (y2 - x2), k3y = x2 * (b - z2) - y2, k3z = x2 * y2 - c * z2;
+                float x3 = x0 + dt * k3x, y3 = y0 + dt * k3y, z3 = z0 + dt * k3z;
+                float k4x = a * (y3 - x3), k4y = x3 * (b - z3) - y3, k4z = x3 * y3 - c * z3;
+                bx[l] = x0 + sixth * (k1x + 2.0f * k2x + 2.0f * k3x + k4x);
+                by[l] = y0 + sixth * (k1y + 2.0f * k2y + 2.0f * k3y + k4y);
+                bz[l] = z0 + sixth * (k1z + 2.0f * k2z + 2.0f * k3z + k4z);
+            }
+        }
+    }
+}
+
+// Templated kernels vs hand-written Lorenz, then every system (1 thread)
+int RunAttractorBenchmark() {
+    const int count = 100000;
+    const int steps = 200;
+    const int LANES = Ensemble::LANES;
+    std::vector<float> x(count), y(count), z(count);
+
+    auto reset = [&](const AttractorInfo& info) {
+        for (int i = 0; i < count; i++) {
+            x[i] = info.x0 + 1e-4f * (i % 97);
+            y[i] = info.y0 + 1e-4f * (i % 89);
+            z[i] = info.z0 + 1e-4f * (i % 83);
+        }
+    };
+    auto rate = [&](std::chrono::steady_clock::time_point start) {
+        return (double)count * steps / SecondsSince(start) / 1e6;
+    };
+
+    const AttractorInfo& lorenz = GetAttractorInfo(LORENZ);
+    const AttractorParams& p = lorenz.params;
+
+    reset(lorenz);
+    auto start = std::chrono::steady_clock::now();
+    HandWrittenLorenzRk4(x.data(), y.data(), z.data(), count / LANES, steps, p.a, p.b, p.c, lorenz.dt);
+    double handRate = rate(start);
+    float handX = x[count / 2];
+
+    reset(lorenz);
+    start = std::chrono::steady_clock::now();
+    AdvanceBlocks<RK4, LANES>(LORENZ, p, x.data(), y.data(), z.data(), count / LANES, steps, lorenz.dt);
+    double templRate = rate(start);
+
+    printf("Lorenz RK4, %d trajectories x %d steps\n", count, steps);
+    printf("  hand-written   %8.1f Msteps/s\n", handRate);
+    printf("  templated      %8.1f Msteps/s  (%.0f%%, same result: %s)\n",
+           templRate, 100.0 * templRate / handRate, handX == x[count / 2] ? "yes" : "no");
+
+    // Single-trajectory Euler, the path the trail uses
+    const int serialSteps = 10000000;
+    float sx = lorenz.x0, sy = lorenz.y0, sz = lorenz.z0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < serialSteps; i++) {
+        float dx = p.a * (sy - sx) * lorenz.dt;
+        float dy = (sx * (p.b - sz) - sy) * lorenz.dt;
+        float dz = (sx * sy - p.c * sz) * lorenz.dt;
+        sx += dx; sy += dy; sz += dz;
+    }
+    double handSerial = serialSteps / SecondsSince(start) / 1e6;
+    float tx = lorenz.x0, ty = lorenz.y0, tz = lorenz.z0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < serialSteps; i++) StepPoint<Euler>(LORENZ, p, tx, ty, tz, lorenz.dt);
+    double templSerial = serialSteps / SecondsSince(start) / 1e6;
+    printf("Lorenz Euler, single trajectory\n");
+    printf("  hand-written   %8.1f Msteps/s\n", handSerial);
+    printf("  templated      %8.1f Msteps/s  (same result: %s)\n", templSerial,
+           (sx == tx && sy == ty && sz == tz) ? "yes" : "no");
+
+    printf("RK4 by system\n");
+    for (int k = 0; k < ATTRACTOR_COUNT; k++) {
+        const AttractorInfo& info = GetAttractorInfo((AttractorKind)k);
+        reset(info);
+        start = std::chrono::steady_clock::now();
+        AdvanceBlocks<RK4, LANES>((AttractorKind)k, info.params, x.data(), y.data(), z.data(),
+                                  count / LANES, steps, info.dt);
+        printf("  %-10s %8.1f Msteps/s\n", info.name, rate(start));
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) return RunTrailBenchmark();
+    if (argc > 1 && strcmp(argv[1], "--bench-ensemble") == 0) {
+        int count = (argc > 2) ? atoi(argv[2]) : 100000;
+        int threads = (argc > 3) ? atoi(argv[3]) : (int)std::thread::hardware_concurrency();
+        return RunEnsembleBenchmark(count, threads > 0 ? threads : 1);
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-attractor") == 0) return RunAttractorBenchmark();
+
+    InitWindow(800, 600, "3D Strange Attractors");
     SetTargetFPS(60);
 
     Camera3D camera = {0};
@@ -22,15 +220,17 @@ int main() {
     camera.up = {0.0f, 1.0f, 0.0f};
     camera.fovy = 45.0f;
 
-    // Lorenz system initial values
-    float x = 0.01f, y = 0.0f, z = 0.0f;
-    const float x0 = 0.01f, y0 = 0.0f, z0 = 0.0f;
+    // Attractor selection (1-5) and initial values
+    AttractorKind kind = LORENZ;
+    const AttractorInfo* info = &GetAttractorInfo(kind);
+    float x = info->x0, y = info->y0, z = info->z0;
 
-    float a = 10.0f, b = 28.0f, c = 8.0f / 3.0f;
-    float dt = 0.01f;
+    AttractorParams params = info->params;   // a, b, c
+    float dt = info->dt;
 
-    std::deque<Point3D> points;
     const int maxPoints = 2000;
+    TrailBuffer points(maxPoints);
+    TrailRenderer trailRenderer;
 
     float angle = 0.0f;     // camera rotation
     float radius = 50.0f;   // camera distance
@@ -38,37 +238,71 @@ int main() {
     // Random starting hue for trail
     float startHue = GetRandomValue(0, 359);
 
+    // Ensemble mode: many perturbed trajectories, each drawn as its head
+    bool ensembleMode = false;
+    int ensembleSize = 100000;
+    Ensemble ensemble;
+    ThreadPool pool;
+    double stepsPerSecond = 0.0;
+
     while (!WindowShouldClose()) {
+        // --- Pick an attractor with 1-5 ---
+        bool reset = IsKeyPressed(KEY_SPACE);
+        for (int k = 0; k < ATTRACTOR_COUNT; k++) {
+            if (IsKeyPressed(KEY_ONE + k)) {
+                kind = (AttractorKind)k;
+                info = &GetAttractorInfo(kind);
+                reset = true;
+            }
+        }
+
         // --- Reset if space bar pressed ---
-        if (IsKeyPressed(KEY_SPACE)) {
-            points.clear();
-            x = x0; y = y0; z = z0;
+        if (reset) {
+            points.Clear();
+            x = info->x0; y = info->y0; z = info->z0;
             angle = 0.0f;
             radius = 50.0f;
             startHue = GetRandomValue(0, 359);
+            params = info->params;
+            dt = info->dt;
+            if (ensembleMode) ensemble.Reset(ensembleSize, {x, y, z}, 0.01f, GetRandomValue(0, 1 << 30));
         }
 
-        // --- Lorenz integration (Euler) ---
-        float dx = a * (y - x) * dt;
-        float dy = (x * (b - z) - y) * dt;
-        float dz = (x * y - c * z) * dt;
-        x += dx; y += dy; z += dz;
+        // --- Ensemble controls: TAB toggles, [ ] halve/double the count ---
+        bool resize = false;
+        if (IsKeyPressed(KEY_TAB)) { ensembleMode = !ensembleMode; resize = ensembleMode; }
+        if (IsKeyPressed(KEY_LEFT_BRACKET) && ensembleSize > 1000) { ensembleSize /= 2; resize = ensembleMode; }
+        if (IsKeyPressed(KEY_RIGHT_BRACKET) && ensembleSize < 1000000) { ensembleSize = std::min(ensembleSize * 2, 1000000); resize = ensembleMode; }
+        if (resize) ensemble.Reset(ensembleSize, {info->x0, info->y0, info->z0}, 0.01f, GetRandomValue(0, 1 << 30));
 
-        // Add new point
-        points.push_back({{x, y, z}, 0.0f});
-        if (points.size() > maxPoints) points.pop_front(); // O(1) removal
+        // --- Live parameters: Q/A = a, W/S = b, E/D = c (0.5% of default per frame) ---
+        const AttractorParams& def = info->params;
+        if (IsKeyDown(KEY_Q)) params.a += 0.005f * fabsf(def.a);
+        if (IsKeyDown(KEY_A)) params.a -= 0.005f * fabsf(def.a);
+        if (IsKeyDown(KEY_W)) params.b += 0.005f * fabsf(def.b);
+        if (IsKeyDown(KEY_S)) params.b -= 0.005f * fabsf(def.b);
+        if (IsKeyDown(KEY_E)) params.c += 0.005f * fabsf(def.c);
+        if (IsKeyDown(KEY_D)) params.c -= 0.005f * fabsf(def.c);
 
-        // --- Compute center ---
-        Vector3 center = {0.0f, 0.0f, 0.0f};
-        for (const auto& p : points) {
-            center.x += p.pos.x;
-            center.y += p.pos.y;
-            center.z += p.pos.z;
-        }
-        if (!points.empty()) {
-            center.x /= points.size();
-            center.y /= points.size();
-            center.z /= points.size();
+        Vector3 center;
+        if (ensembleMode) {
+            // --- Ensemble integration (RK4, threaded) ---
+            double start = GetTime();
+            ensemble.Step(kind, params, dt, 1, &pool);
+            double elapsed = GetTime() - start;
+            if (elapsed > 0.0) stepsPerSecond = ensemble.Size() / elapsed;
+            Vector3 c = ensemble.Centroid();
+            center = {c.x * info->scale, c.y * info->scale, c.z * info->scale};
+        } else {
+            // --- Attractor integration (Euler) ---
+            StepPoint<Euler>(kind, params, x, y, z, dt);
+
+            // Add new point (evicts the oldest once the ring is full)
+            float s = info->scale;
+            points.Push({{x * s, y * s, z * s}, 0.0f});
+
+            // --- Compute center (running sum, O(1)) ---
+            center = points.Centroid();
         }
 
         // --- Keyboard-controlled rotation ---
@@ -102,18 +336,20 @@ int main() {
         ClearBackground(BLACK);
         BeginMode3D(camera);
 
-        if (points.size() > 1) {
-            for (size_t i = 1; i < points.size(); i++) {
-                // Color gradient along trail with fading brightness
-                float t = (float)i / points.size();      // 0 oldest -> 1 newest
-                float hue = fmod(startHue + t * 360.0f, 360.0f);
-                Color col = ColorFromHSV(hue, 1.0f, t); // fade brightness
-                DrawLine3D(points[i-1].pos, points[i].pos, col);
-            }
+        if (ensembleMode) {
+            ensemble.Draw(info->scale);
+        } else {
+            // Hue gradient + fading brightness, batched into one line list
+            trailRenderer.Draw(points, startHue);
         }
 
         EndMode3D();
         DrawFPS(10, 10);
+        DrawText(TextFormat("%s  a %.3f  b %.3f  c %.3f", info->name, params.a, params.b, params.c),
+                 10, 35, 20, RAYWHITE);
+        if (ensembleMode)
+            DrawText(TextFormat("%d trajectories  %.1f M steps/s (%d threads)",
+                                ensemble.Size(), stepsPerSecond / 1e6, pool.Size()), 10, 60, 20, RAYWHITE);
         EndDrawing();
     }
 